@@ -0,0 +1,548 @@
+/**
+ * Author	: @makermatty (maker.matejsuchanek.cz)
+ * Date		: 15-10-2026
+ *
+ * Micro-benchmarks of the filter update paths
+ * Every case replays the same pseudo-random signal through one filter and reports
+ * throughput, per-call latency percentiles and the bytes of state the filter holds.
+ * Latency is sampled per group of kGroup calls, a single update is far below the
+ * resolution of the clock. Block cases (suffix "[blk]") process kBlock samples per
+ * call and report the figures per sample.
+ *
+ * usage: MakerMatty_Bench [samples per case]
+ */
+
+#include "MakerMatty_Curves.h"
+#include "MakerMatty_Parallel.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+const size_t kGroup = 64;
+const size_t kSignal = 4096; // power of two, indexed by mask
+const size_t kBlock = 256; // samples per call of the block APIs
+const size_t kRecording = 1 << 20; // samples per call of the offline parallel APIs
+
+volatile double g_sink;
+
+struct Result {
+    double msps;
+    double p50;
+    double p99;
+    double p999;
+};
+
+template <class T>
+std::vector<T> makeSignal()
+{
+    std::vector<T> signal(kSignal);
+    uint32_t seed = 0x12345678;
+    for (size_t i = 0; i < kSignal; i++) {
+        seed = seed * 1664525 + 1013904223;
+        // 12 bit ADC-like samples around mid scale
+        signal[i] = (T)(2048 + (int32_t)((seed >> 20) & 0x3ff) - 512);
+    }
+    return signal;
+}
+
+template <class Step>
+Result measure(size_t samples, Step step, size_t block = 1)
+{
+    typedef std::chrono::steady_clock Clock;
+
+    const size_t groups = std::max<size_t>(samples / (kGroup * block), 1);
+    std::vector<double> ns(groups);
+    double sink = 0;
+    size_t i = 0;
+
+    // warm up caches and branch predictors
+    for (size_t g = 0; g < std::min<size_t>(groups, 64); g++) {
+        for (size_t k = 0; k < kGroup; k++, i++) {
+            sink += step(i);
+        }
+    }
+
+    double total = 0;
+    for (size_t g = 0; g < groups; g++) {
+        const Clock::time_point start = Clock::now();
+        for (size_t k = 0; k < kGroup; k++, i++) {
+            sink += step(i);
+        }
+        const Clock::time_point stop = Clock::now();
+        ns[g] = std::chrono::duration<double, std::nano>(stop - start).count();
+        total += ns[g];
+    }
+    g_sink = sink;
+
+    std::sort(ns.begin(), ns.end());
+    Result result;
+    result.msps = (double)(groups * kGroup * block) / total * 1e3;
+    result.p50 = ns[groups * 50 / 100] / (kGroup * block);
+    result.p99 = ns[groups * 99 / 100] / (kGroup * block);
+    result.p999 = ns[groups * 999 / 1000] / (kGroup * block);
+    return result;
+}
+
+void printHeader()
+{
+    printf("%-20s %-8s %6s %9s %10s %8s %8s %8s\n",
+        "filter", "type", "n", "state_B", "Msample/s", "p50_ns", "p99_ns", "p999_ns");
+}
+
+void print(const char* filter, const char* type, unsigned n, size_t bytes, const Result& r)
+{
+    printf("%-20s %-8s %6u %9zu %10.2f %8.2f %8.2f %8.2f\n",
+        filter, type, n, bytes, r.msps, r.p50, r.p99, r.p999);
+}
+
+// object plus the array when it does not fit inline
+template <class T>
+size_t maBytes(unsigned n)
+{
+    return sizeof(MA<T>) + (n > MA<T>::INLINE_N ? n * sizeof(T) : 0);
+}
+
+const unsigned kWindows[] = { 1, 4, 16, 64, 256, 1024, 4096, 65535 };
+
+void benchEMA(size_t samples)
+{
+    const std::vector<float> signal = makeSignal<float>();
+    for (unsigned n : kWindows) {
+        EMA ema(n, signal[0]);
+        const Result r = measure(samples, [&](size_t i) {
+            return ema.update(signal[i & (kSignal - 1)]);
+        });
+        print("EMA", "float", n, sizeof(ema), r);
+    }
+}
+
+void benchEMADouble(size_t samples)
+{
+    const std::vector<double> signal = makeSignal<double>();
+    for (unsigned n : kWindows) {
+        EMABasic<double> ema(n, signal[0]);
+        const Result r = measure(samples, [&](size_t i) {
+            return ema.update(signal[i & (kSignal - 1)]);
+        });
+        print("EMABasic", "double", n, sizeof(ema), r);
+    }
+}
+
+void benchEMABlock(size_t samples)
+{
+    const std::vector<float> signal = makeSignal<float>();
+    std::vector<float> out(kBlock);
+    for (unsigned n : kWindows) {
+        EMA ema(n, signal[0]);
+        const Result r = measure(samples, [&](size_t i) {
+            return ema.update(&signal[(i * kBlock) & (kSignal - 1)], kBlock, out.data());
+        }, kBlock);
+        print("EMA[blk]", "float", n, sizeof(ema), r);
+    }
+}
+
+void benchEMAFixed(size_t samples)
+{
+    const std::vector<int32_t> signal = makeSignal<int32_t>();
+    for (unsigned n : kWindows) {
+        EMAFixed<16> ema(n, EMAFixed<16>::toFixed(signal[0]));
+        const Result r = measure(samples, [&](size_t i) {
+            return ema.update(EMAFixed<16>::toFixed(signal[i & (kSignal - 1)]));
+        });
+        print("EMAFixed<16>", "int32_t", n, sizeof(ema), r);
+    }
+}
+
+template <class T>
+void benchMAParallel(const char* type, size_t samples)
+{
+    const std::vector<T> signal = makeSignal<T>();
+    std::vector<T> recording(kRecording);
+    for (size_t i = 0; i < kRecording; i++) {
+        recording[i] = signal[i & (kSignal - 1)];
+    }
+    std::vector<T> out(kRecording);
+    MMThreadPool pool;
+
+    MA<T> serial(100);
+    const Result r = measure(samples / 64, [&](size_t) {
+        serial.setValue(0);
+        return serial.update(recording.data(), kRecording, out.data());
+    }, kRecording);
+    print("MA[rec]", type, 100, maBytes<T>(100), r);
+
+    const Result p = measure(samples / 64, [&](size_t) {
+        MAParallel(recording.data(), kRecording, 100, out.data(), pool);
+        return out[kRecording - 1];
+    }, kRecording);
+    print("MAParallel", type, pool.getThreads(), 0, p);
+}
+
+// one sample pushed and popped in blocks of 64 into MA, the queue cost of an ISR handoff
+template <class T, MMQueueOverflow P>
+void benchQueue(const char* type, size_t samples)
+{
+    const std::vector<T> signal = makeSignal<T>();
+    MMSPSCQueue<T, 256, P> queue;
+    MA<T> ma(16);
+    T block[64];
+    const Result r = measure(samples, [&](size_t i) {
+        queue.push(signal[i & (kSignal - 1)]);
+        if (queue.getCount() >= 64) {
+            ma.update(block, queue.pop(block, 64));
+        }
+        return ma.getValue();
+    });
+    print(P == MM_QUEUE_DROP_NEWEST ? "MMSPSCQueue[new]+MA" : "MMSPSCQueue[old]+MA", type, 256, sizeof(queue), r);
+}
+
+// n is the number of channels, figures are per channel sample
+void benchEMABank(size_t samples)
+{
+    const std::vector<float> signal = makeSignal<float>();
+    const unsigned channels[] = { 16, 256, 1024 };
+    for (unsigned c : channels) {
+        std::vector<EMA> emas(c, EMA(16, signal[0]));
+        const Result aos = measure(samples, [&](size_t i) {
+            const float* frame = &signal[(i * c) & (kSignal - 1)];
+            float sum = 0;
+            for (unsigned ch = 0; ch < c; ch++) {
+                sum += emas[ch].update(frame[ch]);
+            }
+            return sum;
+        }, c);
+        print("EMA[ch]", "float", c, c * sizeof(EMA), aos);
+
+        EMABank bank(c, 16, signal[0]);
+        const Result soa = measure(samples, [&](size_t i) {
+            bank.update(&signal[(i * c) & (kSignal - 1)]);
+            return bank.getValue(0);
+        }, c);
+        print("EMABank", "float", c, sizeof(bank) + c * 5 * sizeof(float), soa);
+    }
+}
+
+// mean and variance as two EMAs and a sqrt per sample against EMVar
+void benchEMVar(size_t samples)
+{
+    const std::vector<float> signal = makeSignal<float>();
+    for (unsigned n : kWindows) {
+        EMA mean(n, signal[0]);
+        EMA squares(n, signal[0] * signal[0]);
+        const Result pair = measure(samples, [&](size_t i) {
+            const float x = signal[i & (kSignal - 1)];
+            const float m = mean.update(x);
+            const float variance = squares.update(x * x) - m * m;
+            return (x - m) / sqrtf(variance > 0 ? variance : 1e-6f);
+        });
+        print("EMA x2", "float", n, sizeof(mean) + sizeof(squares), pair);
+
+        EMVar<float> var(n, signal[0]);
+        const Result r = measure(samples, [&](size_t i) {
+            const float x = signal[i & (kSignal - 1)];
+            const float z = var.getZScore(x);
+            var.update(x);
+            return z;
+        });
+        print("EMVar", "float", n, sizeof(var), r);
+    }
+}
+
+// jittered timestamps, alpha from expf() per sample against EMATimed
+void benchEMATimed(size_t samples)
+{
+    const std::vector<float> signal = makeSignal<float>();
+    std::vector<uint32_t> timestamps(kSignal);
+    for (size_t i = 0; i < kSignal; i++) {
+        timestamps[i] = (uint32_t)(i * 1000 + ((uint32_t)signal[i] & 0x1ff));
+    }
+
+    for (unsigned n : kWindows) {
+        const float tau = 1000.0f * (n + 1) / 2;
+
+        float value = signal[0];
+        uint32_t last = 0;
+        const Result libm = measure(samples, [&](size_t i) {
+            const uint32_t t = timestamps[i & (kSignal - 1)];
+            const float alpha = 1.0f - expf(-(float)(t - last) / tau);
+            last = t;
+            return value += (signal[i & (kSignal - 1)] - value) * alpha;
+        });
+        print("EMA+expf", "float", n, sizeof(value) + sizeof(last) + sizeof(tau), libm);
+
+        EMATimed<float> ema(tau);
+        const Result r = measure(samples, [&](size_t i) {
+            return ema.update(timestamps[i & (kSignal - 1)], signal[i & (kSignal - 1)]);
+        });
+        print("EMATimed", "float", n, sizeof(ema), r);
+    }
+}
+
+// runs of kBlock equal samples, as a loop of update() and as one updateRepeated()
+void benchEMARepeated(size_t samples)
+{
+    const std::vector<float> signal = makeSignal<float>();
+    EMA loop(16, signal[0]);
+    const Result r = measure(samples, [&](size_t i) {
+        const float x = signal[i & (kSignal - 1)];
+        for (size_t k = 0; k < kBlock; k++) {
+            loop.update(x);
+        }
+        return loop.getValue();
+    }, kBlock);
+    print("EMA[rep]", "float", 16, sizeof(loop), r);
+
+    EMA ema(16, signal[0]);
+    const Result closed = measure(samples, [&](size_t i) {
+        return ema.updateRepeated(signal[i & (kSignal - 1)], kBlock);
+    }, kBlock);
+    print("EMA.updateRepeated", "float", 16, sizeof(ema), closed);
+}
+
+// offline recording, serial block update against the chunked scan on every hardware thread
+void benchEMAParallel(size_t samples)
+{
+    const std::vector<float> signal = makeSignal<float>();
+    std::vector<float> recording(kRecording);
+    for (size_t i = 0; i < kRecording; i++) {
+        recording[i] = signal[i & (kSignal - 1)];
+    }
+    std::vector<float> out(kRecording);
+    MMThreadPool pool;
+
+    EMA serial(16, signal[0]);
+    const Result r = measure(samples / 64, [&](size_t) {
+        return serial.update(recording.data(), kRecording, out.data());
+    }, kRecording);
+    print("EMA[rec]", "float", 16, sizeof(serial), r);
+
+    EMA parallel(16, signal[0]);
+    const Result p = measure(samples / 64, [&](size_t) {
+        return EMAParallelUpdate(parallel, recording.data(), kRecording, out.data(), pool);
+    }, kRecording);
+    print("EMAParallelUpdate", "float", pool.getThreads(), sizeof(parallel), p);
+}
+
+template <int N>
+void benchEMATemplated(size_t samples)
+{
+    const std::vector<float> signal = makeSignal<float>();
+    EMATemplated<N> ema(signal[0]);
+    const Result r = measure(samples, [&](size_t i) {
+        return ema.update(signal[i & (kSignal - 1)]);
+    });
+    print("EMATemplated", "float", N, sizeof(ema), r);
+}
+
+template <class T>
+void benchMA(const char* type, size_t samples)
+{
+    const std::vector<T> signal = makeSignal<T>();
+    for (unsigned n : kWindows) {
+        MA<T> ma(n);
+        const Result r = measure(samples, [&](size_t i) {
+            return ma.update(signal[i & (kSignal - 1)]);
+        });
+        print("MA", type, n, maBytes<T>(n), r);
+    }
+}
+
+template <class T, uint16_t N>
+void benchMATemplated(const char* type, size_t samples)
+{
+    const std::vector<T> signal = makeSignal<T>();
+    static MATemplated<T, N> ma;
+    const Result r = measure(samples, [&](size_t i) {
+        return ma.update(signal[i & (kSignal - 1)]);
+    });
+    print("MATemplated", type, N, sizeof(ma), r);
+}
+
+template <class T>
+void benchMATemplated(const char* type, size_t samples)
+{
+    benchMATemplated<T, 1>(type, samples);
+    benchMATemplated<T, 4>(type, samples);
+    benchMATemplated<T, 16>(type, samples);
+    benchMATemplated<T, 64>(type, samples);
+    benchMATemplated<T, 100>(type, samples);
+    benchMATemplated<T, 256>(type, samples);
+    benchMATemplated<T, 1024>(type, samples);
+    benchMATemplated<T, 4096>(type, samples);
+}
+
+template <class T>
+void benchMABlock(const char* type, size_t samples)
+{
+    const std::vector<T> signal = makeSignal<T>();
+    std::vector<T> out(kBlock);
+    for (unsigned n : kWindows) {
+        MA<T> ma(n);
+        const Result r = measure(samples, [&](size_t i) {
+            return ma.update(&signal[(i * kBlock) & (kSignal - 1)], kBlock, out.data());
+        }, kBlock);
+        print("MA[blk]", type, n, maBytes<T>(n), r);
+    }
+}
+
+// n is the number of channels, figures are per channel sample
+template <class T>
+void benchMABank(const char* type, size_t samples)
+{
+    const std::vector<T> signal = makeSignal<T>();
+    const unsigned channels[] = { 16, 256, 1024 };
+    for (unsigned c : channels) {
+        std::vector<MA<T>> mas;
+        for (unsigned ch = 0; ch < c; ch++) {
+            mas.emplace_back(16);
+        }
+        const Result aos = measure(samples, [&](size_t i) {
+            const T* frame = &signal[(i * c) & (kSignal - 1)];
+            double sum = 0;
+            for (unsigned ch = 0; ch < c; ch++) {
+                sum += mas[ch].update(frame[ch]);
+            }
+            return sum;
+        }, c);
+        print("MA[ch]", type, c, c * maBytes<T>(16), aos);
+
+        MABank<T> bank(c, 16);
+        const Result bank_r = measure(samples, [&](size_t i) {
+            bank.update(&signal[(i * c) & (kSignal - 1)]);
+            return (double)bank.getValue(0);
+        }, c);
+        print("MABank", type, c, sizeof(bank) + c * (sizeof(typename MAAccumulator<T>::type) + 17 * sizeof(T)), bank_r);
+    }
+}
+
+template <class T>
+void benchMAVar(const char* type, size_t samples)
+{
+    const std::vector<T> signal = makeSignal<T>();
+    for (unsigned n : kWindows) {
+        MAVar<T> var(n);
+        const Result r = measure(samples, [&](size_t i) {
+            var.update(signal[i & (kSignal - 1)]);
+            return var.getVariance();
+        });
+        print("MAVar", type, n, sizeof(var) + n * sizeof(T), r);
+    }
+}
+
+template <class T>
+void benchMovingRange(const char* type, size_t samples)
+{
+    const std::vector<T> signal = makeSignal<T>();
+    for (unsigned n : kWindows) {
+        MovingRange<T> range(n);
+        const Result r = measure(samples, [&](size_t i) {
+            return range.update(signal[i & (kSignal - 1)]);
+        });
+        print("MovingRange", type, n, sizeof(range) + n * (sizeof(T) + 2 * sizeof(uint16_t)), r);
+    }
+}
+
+// heap or histogram, as MovingMedian<T> picks it or forced with P
+template <class T, MovingMedianPath P = MovingMedianMethod<T, 0>::value>
+void benchMovingMedian(const char* type, size_t samples)
+{
+    const std::vector<T> signal = makeSignal<T>();
+    const unsigned windows[] = { 3, 9, 101, 1001, 65535 };
+    for (unsigned n : windows) {
+        MovingMedian<T, 0, P> median(n);
+        const Result r = measure(samples, [&](size_t i) {
+            return median.update(signal[i & (kSignal - 1)]);
+        });
+        const size_t bytes = P == MM_MEDIAN_HISTOGRAM
+            ? ((size_t)1 << (8 * sizeof(T))) * 2 + (sizeof(T) == 1 ? 16 : 256) * 2 + n * sizeof(T)
+            : n * (sizeof(T) + 2 * sizeof(uint16_t));
+        print(P == MM_MEDIAN_HISTOGRAM ? "MovingMedian[hist]" : "MovingMedian[heap]", type, n, sizeof(median) + bytes, r);
+    }
+}
+
+template <class T, uint16_t N>
+void benchMovingMedianNetwork(const char* type, size_t samples)
+{
+    const std::vector<T> signal = makeSignal<T>();
+    MovingMedian<T, N> median;
+    const Result r = measure(samples, [&](size_t i) {
+        return median.update(signal[i & (kSignal - 1)]);
+    });
+    print("MovingMedian<N>", type, N, sizeof(median), r);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const size_t samples = argc > 1 ? strtoul(argv[1], nullptr, 10) : (1 << 20);
+
+    printHeader();
+
+    benchEMA(samples);
+    benchEMADouble(samples);
+    benchEMABlock(samples);
+    benchEMAFixed(samples);
+    benchEMABank(samples);
+    benchEMVar(samples);
+    benchEMATimed(samples);
+    benchEMARepeated(samples);
+    benchEMAParallel(samples);
+
+    benchEMATemplated<1>(samples);
+    benchEMATemplated<4>(samples);
+    benchEMATemplated<16>(samples);
+    benchEMATemplated<64>(samples);
+    benchEMATemplated<256>(samples);
+    benchEMATemplated<1024>(samples);
+    benchEMATemplated<4096>(samples);
+    benchEMATemplated<65535>(samples);
+
+    benchMA<int16_t>("int16_t", samples);
+    benchMA<int32_t>("int32_t", samples);
+    benchMA<float>("float", samples);
+    benchMA<double>("double", samples);
+
+    benchMATemplated<int16_t>("int16_t", samples);
+    benchMATemplated<int32_t>("int32_t", samples);
+    benchMATemplated<float>("float", samples);
+    benchMATemplated<double>("double", samples);
+
+    benchMABlock<int16_t>("int16_t", samples);
+    benchMABlock<int32_t>("int32_t", samples);
+    benchMABlock<float>("float", samples);
+    benchMABlock<double>("double", samples);
+
+    benchMAParallel<int16_t>("int16_t", samples);
+    benchMAParallel<float>("float", samples);
+
+    benchQueue<int16_t, MM_QUEUE_DROP_NEWEST>("int16_t", samples);
+    benchQueue<int16_t, MM_QUEUE_DROP_OLDEST>("int16_t", samples);
+    benchQueue<float, MM_QUEUE_DROP_NEWEST>("float", samples);
+
+    benchMABank<int16_t>("int16_t", samples);
+    benchMABank<float>("float", samples);
+
+    benchMAVar<int16_t>("int16_t", samples);
+    benchMAVar<float>("float", samples);
+
+    benchMovingRange<int16_t>("int16_t", samples);
+    benchMovingRange<float>("float", samples);
+
+    benchMovingMedian<int16_t>("int16_t", samples);
+    benchMovingMedian<int16_t, MM_MEDIAN_HISTOGRAM>("int16_t", samples);
+    benchMovingMedian<uint8_t>("uint8_t", samples);
+    benchMovingMedian<float>("float", samples);
+    benchMovingMedianNetwork<float, 3>("float", samples);
+    benchMovingMedianNetwork<float, 5>("float", samples);
+    benchMovingMedianNetwork<float, 7>("float", samples);
+    benchMovingMedianNetwork<float, 9>("float", samples);
+
+    return 0;
+}
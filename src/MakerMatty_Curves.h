@@ -7,7 +7,13 @@
 #define _MM_CURVES_h
 
 #include "MakerMatty_EMA.h"
+#include "MakerMatty_EMABank.h"
 #include "MakerMatty_MA.h"
+#include "MakerMatty_MABank.h"
+#include "MakerMatty_MAVar.h"
+#include "MakerMatty_Median.h"
+#include "MakerMatty_MinMax.h"
+#include "MakerMatty_Queue.h"
 
 
 
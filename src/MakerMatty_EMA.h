@@ -5,63 +5,538 @@
  * Generic Exponential Moving Average Class
  */
 
-class EMA {
+#ifndef _MM_EMA_H
+#define _MM_EMA_H
+
+#include "MakerMatty_Platform.h"
+
+#include <math.h>
+#include <type_traits>
+
+/**
+ * Type of alpha used for filtering values of type T
+ * float for float and integer values, double for double. Vector-like value types
+ * specialize it to their scalar type (they need T + T and T * coefficient).
+ * For integer-only filtering see EMAFixed.
+ */
+template <class T>
+struct EMACoefficient {
+    typedef float type;
+};
+
+template <>
+struct EMACoefficient<double> {
+    typedef double type;
+};
+
+template <>
+struct EMACoefficient<long double> {
+    typedef long double type;
+};
+
+/**
+ * base^exp by squaring, O(log exp) multiplications
+ */
+template <class K>
+inline K EMAPower(K base, uint64_t exp)
+{
+    K result = K(1);
+    while (exp) {
+        if (exp & 1) {
+            result *= base;
+        }
+        base *= base;
+        exp >>= 1;
+    }
+    return result;
+}
+
+/**
+ * Period of an EMA
+ * N > 0 is known at compile time, alpha = 2 / (N + 1) is a constant and takes no memory.
+ * N == 0 is set at runtime, alpha and 1 - alpha are stored and can be changed any time.
+ */
+template <class K, int N>
+class EMAPeriod {
+    static_assert(N > 0, "N must be positive, 0 selects the runtime period");
+
+public:
+    K getAlpha() const
+    {
+        return alpha();
+    }
+
+protected:
+    static constexpr K alpha()
+    {
+        return K(2) / K(N + 1);
+    }
+
+    static constexpr K beta()
+    {
+        return K(1) - alpha();
+    }
+};
+
+template <class K>
+class EMAPeriod<K, 0> {
 
 public:
-    EMA()
-        : m_n(1)
+    EMAPeriod()
     {
-        m_values[0] = 0;
-        m_values[1] = 0;
-        m_values[2] = 0;
+        this->setPeriod(1);
     }
 
-    EMA(int n, float value)
-        : m_n(n)
+    /**
+     * @name setPeriod
+     * @param n  number of samples, alpha = 2 / (n + 1)
+     * Cheap enough to change the period at runtime, the value is kept.
+     */
+    void setPeriod(int n)
     {
+        this->setAlpha(K(2) / ((n < 1 ? 1 : n) + 1));
+    }
+
+    /**
+     * @name setAlpha
+     * @param alpha  weight of the new sample, clamped to [0, 1]
+     */
+    void setAlpha(K alpha)
+    {
+        m_alpha = alpha > K(1) ? K(1) : (alpha < K(0) ? K(0) : alpha);
+        m_beta = K(1) - m_alpha;
+    }
+
+    K getAlpha() const
+    {
+        return m_alpha;
+    }
+
+protected:
+    K alpha() const
+    {
+        return m_alpha;
+    }
+
+    K beta() const
+    {
+        return m_beta;
+    }
+
+private:
+    K m_alpha; // weight of the new sample
+    K m_beta; // 1 - m_alpha
+};
+
+/**
+ * Exponential Moving Average template
+ * T is the value type (float, double or a vector-like type), N the period known at compile
+ * time or 0 for a runtime period (setPeriod / setAlpha). Keeps the last three values for
+ * getSlope() and getCurve(). EMA is EMABasic<float>.
+ */
+template <class T, int N = 0>
+class EMABasic : public EMAPeriod<typename EMACoefficient<T>::type, N> {
+
+public:
+    EMABasic()
+    {
+        this->setValue(T());
+    }
+
+    template <int M = N, class = typename std::enable_if<M == 0>::type>
+    EMABasic(int n, const T& value)
+    {
+        this->setPeriod(n);
         this->setValue(value);
     }
 
-    float update(float val)
+    template <int M = N, class = typename std::enable_if<M != 0>::type>
+    EMABasic(const T& value)
+    {
+        this->setValue(value);
+    }
+
+    T update(const T& val)
     {
         m_values[2] = m_values[1];
         m_values[1] = m_values[0];
 
-        const float k = 2.0 / (m_n + 1);
-        return m_values[0] = val * k + m_values[1] * (1.0 - k);
+        return m_values[0] = val * this->alpha() + m_values[1] * this->beta();
 
         // Serial.println(String(m_values[0]) + ", " + String(m_values[1]) + ", " + String(m_values[2]));
     }
 
-    float getValue() const
+    /**
+     * @name update
+     * @param in     block of count samples (e.g. one ADC DMA buffer)
+     * @param out    optional, receives the filtered value after every sample
+     * @returns T    the value after the last sample
+     * Same result as calling update(T) for every sample, the coefficients and
+     * the state stay in registers and the slope/curve history is kept up to date.
+     */
+    T update(const T* in, size_t count, T* out = nullptr)
+    {
+        const typename EMACoefficient<T>::type k = this->alpha();
+        const typename EMACoefficient<T>::type k1 = this->beta();
+
+        T v0 = m_values[0];
+        T v1 = m_values[1];
+        T v2 = m_values[2];
+
+        if (out) {
+            for (size_t i = 0; i < count; i++) {
+                v2 = v1;
+                v1 = v0;
+                out[i] = v0 = in[i] * k + v1 * k1;
+            }
+        } else {
+            for (size_t i = 0; i < count; i++) {
+                v2 = v1;
+                v1 = v0;
+                v0 = in[i] * k + v1 * k1;
+            }
+        }
+
+        m_values[0] = v0;
+        m_values[1] = v1;
+        m_values[2] = v2;
+        return v0;
+    }
+
+    /**
+     * @name updateRepeated
+     * @param val    sample received count times in a row (e.g. "unchanged for count ticks")
+     * @param count  number of samples
+     * @returns T    the value after the last one
+     * Same as calling update(val) count times, in O(log count): after m equal samples the
+     * distance to val has shrunk by (1 - alpha)^m. Slope and curve follow the last samples.
+     */
+    T updateRepeated(const T& val, uint32_t count)
+    {
+        if (count == 0) {
+            return m_values[0];
+        }
+        if (count == 1) {
+            return this->update(val);
+        }
+
+        // v(m) = val + beta^m * (v(0) - val), keep v(m - 2) and v(m - 1) for the history
+        const typename EMACoefficient<T>::type k1 = this->beta();
+        const T diff = m_values[0] - val;
+        const typename EMACoefficient<T>::type power = EMAPower(k1, count - 2);
+
+        m_values[2] = count == 2 ? m_values[0] : val + diff * power;
+        m_values[1] = val + diff * (power * k1);
+        return m_values[0] = val + diff * (power * k1 * k1);
+    }
+
+    T getValue() const
     {
         return m_values[0];
     }
 
-    void setValue(const float value)
+    void setValue(const T& value)
     {
         m_values[0] = value;
         m_values[1] = value;
         m_values[2] = value;
     }
 
-    float getSlope() const
+    T getSlope() const
     {
         return m_values[0] - m_values[1];
     }
 
-    float getCurve() const
+    T getCurve() const
     {
         return (m_values[0] - m_values[1]) - (m_values[1] - m_values[2]);
     }
 
 private:
-    int m_n;
-    float m_values[3];
+    T m_values[3];
+};
+
+typedef EMABasic<float> EMA;
+
+/**
+ * Exponentially weighted mean and variance
+ * One recurrence with the alpha of the EMA for both (West / Finch):
+ *   diff = x - mean, mean += alpha * diff, var = (1 - alpha) * (var + alpha * diff^2)
+ * so the variance follows the same window as the mean without a second EMA of the squares
+ * (which cancels badly when the mean is large against the spread) and the square root is
+ * only taken when the deviation is asked for. T is float or double, N as in EMABasic.
+ */
+template <class T, int N = 0>
+class EMVar : public EMAPeriod<typename EMACoefficient<T>::type, N> {
+    typedef typename EMACoefficient<T>::type K;
+
+public:
+    EMVar()
+    {
+        this->setValue(T());
+    }
+
+    template <int M = N, class = typename std::enable_if<M == 0>::type>
+    EMVar(int n, const T& value)
+    {
+        this->setPeriod(n);
+        this->setValue(value);
+    }
+
+    template <int M = N, class = typename std::enable_if<M != 0>::type>
+    EMVar(const T& value)
+    {
+        this->setValue(value);
+    }
+
+    T update(const T& val)
+    {
+        const T diff = val - m_mean;
+        const T incr = diff * this->alpha();
+        m_mean += incr;
+        m_variance = (m_variance + diff * incr) * this->beta();
+        return m_mean;
+    }
+
+    /**
+     * @name update
+     * @param in     block of count samples
+     * @param out    optional, receives the mean after every sample
+     * @returns T    the mean after the last sample
+     */
+    T update(const T* in, size_t count, T* out = nullptr)
+    {
+        const K k = this->alpha();
+        const K k1 = this->beta();
+
+        T mean = m_mean;
+        T variance = m_variance;
+        for (size_t i = 0; i < count; i++) {
+            const T diff = in[i] - mean;
+            const T incr = diff * k;
+            mean += incr;
+            variance = (variance + diff * incr) * k1;
+            if (out) {
+                out[i] = mean;
+            }
+        }
+
+        m_mean = mean;
+        m_variance = variance;
+        return mean;
+    }
+
+    T getValue() const
+    {
+        return m_mean;
+    }
+
+    /**
+     * @name setValue
+     * Sets the mean, the variance starts from 0 again.
+     */
+    void setValue(const T& value)
+    {
+        m_mean = value;
+        m_variance = 0;
+    }
+
+    T getVariance() const
+    {
+        return m_variance;
+    }
+
+    T getStdDev() const
+    {
+        return (T)sqrt(m_variance);
+    }
+
+    /**
+     * @name getZScore
+     * @param val    sample to rate, call before update(val) to rate it against the history
+     * @returns T    (val - mean) / deviation, 0 while the deviation is 0
+     */
+    T getZScore(const T& val) const
+    {
+        const T deviation = this->getStdDev();
+        return deviation > 0 ? (val - m_mean) / deviation : T(0);
+    }
+
+private:
+    T m_mean;
+    T m_variance;
+};
+
+/**
+ * alpha = 1 - e^(-x) of an EMA over a time step x = dt / tau
+ * float has no use for the last digits of libm, for x < 0.5 the series of -expm1(-x) and
+ * above it e^(-x) from 2^(-x log2(e)) split into a power of two and a polynomial on
+ * [-0.5, 0.5] are accurate to a few 1e-7. double goes through expm1().
+ */
+template <class K>
+struct EMATimedAlpha {
+    static K alpha(const K x)
+    {
+        return x > K(0) ? (K)-expm1(-x) : K(0);
+    }
 };
 
+template <>
+struct EMATimedAlpha<float> {
+    static float alpha(const float x)
+    {
+        if (!(x > 0.0f)) {
+            return 0.0f;
+        }
+        if (x < 0.5f) {
+            // x - x^2/2! + x^3/3! - ... + x^8/8!, error below x^9/9!
+            return x * (1.0f + x * (-1.0f / 2 + x * (1.0f / 6 + x * (-1.0f / 24 + x * (1.0f / 120 + x * (-1.0f / 720 + x * (1.0f / 5040 + x * (-1.0f / 40320))))))));
+        }
+        if (x > 17.0f) {
+            return 1.0f; // e^-17 is below the float resolution of 1
+        }
+
+        // e^-x = 2^y = 2^n * 2^f, n = round(y), |f| <= 0.5
+        const float y = -x * 1.44269504f;
+        const int32_t n = (int32_t)(y - 0.5f);
+        const float g = (y - n) * 0.693147181f; // f * ln(2), |g| <= 0.35
+        const float p = 1.0f + g * (1.0f + g * (1.0f / 2 + g * (1.0f / 6 + g * (1.0f / 24 + g * (1.0f / 120 + g * (1.0f / 720))))));
+
+        const uint32_t bits = (uint32_t)(n + 127) << 23;
+        float scale;
+        memcpy(&scale, &bits, sizeof(scale));
+        return 1.0f - p * scale;
+    }
+};
+
+/**
+ * Exponential Moving Average of irregularly sampled values
+ * Every sample comes with its timestamp and is weighted by the time since the previous one,
+ * alpha = 1 - e^(-dt / tau), so jitter and gaps need no resampling to a fixed grid. After a
+ * gap of tau the old value keeps a weight of 1/e, an EMA of period n sampled every dt has
+ * about tau = dt * (n + 1) / 2.
+ * Timestamps are uint32_t ticks in the unit of tau (millis(), micros(), ...), differences
+ * are taken modulo 2^32 so the wrap of the counter is harmless, they must not go back.
+ * The first sample sets the value.
+ */
+template <class T = float>
+class EMATimed {
+    typedef typename EMACoefficient<T>::type K;
+
+public:
+    EMATimed()
+        : m_timestamp(0)
+        , m_started(false)
+    {
+        this->setTau(1);
+        this->setValue(T());
+    }
+
+    EMATimed(K tau)
+        : m_timestamp(0)
+        , m_started(false)
+    {
+        this->setTau(tau);
+        this->setValue(T());
+    }
+
+    /**
+     * @name setTau
+     * @param tau  time constant in timestamp ticks
+     */
+    void setTau(K tau)
+    {
+        if (!(tau > K(0))) {
+            log_e("tau must be positive");
+            tau = 1;
+        }
+        m_tau = tau;
+        m_rate = K(1) / tau;
+    }
+
+    K getTau() const
+    {
+        return m_tau;
+    }
+
+    T update(const uint32_t timestamp, const T& val)
+    {
+        if (!m_started) {
+            m_started = true;
+            m_timestamp = timestamp;
+            return m_value = val;
+        }
+
+        const uint32_t dt = timestamp - m_timestamp;
+        m_timestamp = timestamp;
+
+        const K alpha = EMATimedAlpha<K>::alpha((K)dt * m_rate);
+        return m_value = m_value + (val - m_value) * alpha;
+    }
+
+    /**
+     * @name update
+     * @param timestamps  timestamp of every sample
+     * @param in          block of count samples
+     * @param out         optional, receives the filtered value after every sample
+     * @returns T         the value after the last sample
+     */
+    T update(const uint32_t* timestamps, const T* in, size_t count, T* out = nullptr)
+    {
+        for (size_t i = 0; i < count; i++) {
+            const T value = this->update(timestamps[i], in[i]);
+            if (out) {
+                out[i] = value;
+            }
+        }
+        return m_value;
+    }
+
+    T getValue() const
+    {
+        return m_value;
+    }
+
+    /**
+     * @name setValue
+     * Sets the value, the next sample is weighted from the time it was set at.
+     */
+    void setValue(const T& value, const uint32_t timestamp)
+    {
+        m_value = value;
+        m_timestamp = timestamp;
+        m_started = true;
+    }
+
+    /**
+     * @name setValue
+     * Sets the value, the next sample replaces it like the first one.
+     */
+    void setValue(const T& value)
+    {
+        m_value = value;
+        m_started = false;
+    }
+
+    uint32_t getTimestamp() const
+    {
+        return m_timestamp;
+    }
+
+private:
+    K m_tau; // time constant
+    K m_rate; // 1 / m_tau
+    T m_value;
+    uint32_t m_timestamp; // timestamp of the last sample
+    bool m_started; // m_timestamp is valid
+};
+
+/**
+ * Compact EMA with the period known at compile time
+ * Keeps only the value (4 bytes), use EMABasic<float, N> for slope and curve.
+ */
 template <int N>
-class EMATemplated {
+class EMATemplated : public EMAPeriod<float, N> {
 
 public:
     EMATemplated()
@@ -76,12 +551,25 @@ public:
 
     float update(float val)
     {
-        constexpr float k = 2.0 / (N + 1.0);
-        return m_value = val * k + m_value * (1.0 - k);
+        return m_value = val * this->alpha() + m_value * this->beta();
 
         // Serial.println(String(m_values[0]) + ", " + String(m_values[1]) + ", " + String(m_values[2]));
     }
 
+    /**
+     * @name updateRepeated
+     * @param val    sample received count times in a row
+     * @param count  number of samples
+     * @returns float the value after the last one, as count calls of update(val) in O(log count)
+     */
+    float updateRepeated(float val, uint32_t count)
+    {
+        if (count == 0) {
+            return m_value;
+        }
+        return m_value = val + (m_value - val) * EMAPower(this->beta(), count);
+    }
+
     float getValue() const
     {
         return m_value;
@@ -95,3 +583,105 @@ public:
 private:
     float m_value;
 };
+
+/**
+ * Fixed-point Exponential Moving Average Class
+ * Integer only, for interrupt handlers and targets where the FPU is off limits.
+ * Values are fixed-point numbers in int32_t with Q fractional bits (raw integer samples
+ * go through toFixed() and come back with toInt()), the extra bits keep the precision
+ * the float EMA has for slow filters.
+ * alpha = 2 / (n + 1) is applied as a rounding shift when n = 2^k - 1, otherwise as a
+ * multiply by alpha in Q30 with a 64 bit intermediate.
+ */
+template <uint8_t Q = 16>
+class EMAFixed {
+    static_assert(Q < 31, "Q must leave room for the integer part");
+
+public:
+    EMAFixed()
+    {
+        this->setPeriod(1);
+        this->setValue(0);
+    }
+
+    EMAFixed(int n, int32_t value)
+    {
+        this->setPeriod(n);
+        this->setValue(value);
+    }
+
+    int32_t update(int32_t val)
+    {
+        m_values[2] = m_values[1];
+        m_values[1] = m_values[0];
+
+        // 64 bit, the difference of two Q values can exceed int32_t (the result never does)
+        const int64_t diff = (int64_t)val - m_values[1];
+        if (!m_alpha) {
+            return m_values[0] = (int32_t)(m_values[1] + (m_shift ? (diff + ((int64_t)1 << (m_shift - 1))) >> m_shift : diff));
+        }
+        return m_values[0] = (int32_t)(m_values[1] + ((diff * m_alpha + (1 << 29)) >> 30));
+    }
+
+    void setPeriod(int n)
+    {
+        if (n < 1) {
+            n = 1;
+        }
+
+        m_shift = 0;
+        if (((n + 1) & n) == 0) {
+            // alpha = 2 / 2^k
+            while ((2 << m_shift) < n + 1) {
+                ++m_shift;
+            }
+            m_alpha = 0;
+        } else {
+            m_alpha = (uint32_t)((((uint64_t)2 << 30) + (n + 1) / 2) / (n + 1));
+        }
+    }
+
+    int32_t getValue() const
+    {
+        return m_values[0];
+    }
+
+    void setValue(const int32_t value)
+    {
+        m_values[0] = value;
+        m_values[1] = value;
+        m_values[2] = value;
+    }
+
+    int32_t getSlope() const
+    {
+        return m_values[0] - m_values[1];
+    }
+
+    int32_t getCurve() const
+    {
+        return (m_values[0] - m_values[1]) - (m_values[1] - m_values[2]);
+    }
+
+    static constexpr int32_t toFixed(const int32_t value)
+    {
+        return value * ((int32_t)1 << Q);
+    }
+
+    static constexpr int32_t toInt(const int32_t fixed)
+    {
+        return Q ? (fixed + ((int32_t)1 << (Q ? Q - 1 : 0))) >> Q : fixed;
+    }
+
+    static constexpr float toFloat(const int32_t fixed)
+    {
+        return fixed / (float)((int32_t)1 << Q);
+    }
+
+private:
+    uint32_t m_alpha; // alpha in Q30, 0 when applied as a shift
+    uint8_t m_shift;
+    int32_t m_values[3];
+};
+
+#endif
@@ -0,0 +1,338 @@
+/**
+ * Author	: @makermatty (maker.matejsuchanek.cz)
+ * Date		: 15-10-2026
+ *
+ * Multi-channel Exponential Moving Average Class
+ * One EMA per channel, stored as structure of arrays: alpha, 1 - alpha and three planes
+ * of values in a single aligned allocation. The planes rotate, so a frame update writes
+ * only the oldest plane (which becomes the newest) and slope and curve come for free.
+ * Frames are updated with AVX or SSE kernels when the compiler targets them and with a
+ * plain loop otherwise. Every channel gives the same values as an EMA with the same period
+ * (unless the compiler contracts one of them into fused multiply-adds).
+ * MM_EMABANK_LANES follows the target flags of every translation unit and sets the padding
+ * and alignment of the planes. Build every file using EMABank with the same -m flags (or
+ * define MM_EMABANK_LANES for all of them): mixing them gives the same inline class two
+ * layouts, an ODR violation that breaks objects passed between those files.
+ */
+
+#ifndef _MM_EMABANK_H
+#define _MM_EMABANK_H
+
+#include "MakerMatty_Platform.h"
+
+#if defined(MM_EMABANK_LANES)
+#if MM_EMABANK_LANES == 8
+#include <immintrin.h>
+#elif MM_EMABANK_LANES == 4
+#include <xmmintrin.h>
+#endif
+#elif defined(__AVX__)
+#include <immintrin.h>
+#define MM_EMABANK_LANES 8
+#elif defined(__SSE__)
+#include <xmmintrin.h>
+#define MM_EMABANK_LANES 4
+#else
+#define MM_EMABANK_LANES 1
+#endif
+
+class EMABank {
+
+public:
+    EMABank();
+    EMABank(const uint16_t channels, int n, float value = 0);
+    EMABank(const EMABank& other); // copy contructor
+    EMABank(EMABank&& other) noexcept; // move contructor
+    ~EMABank();
+
+    void update(const float* frame);
+    void update(const float* frames, size_t count);
+
+    void setPeriod(int n);
+    void setPeriod(const uint16_t channel, int n);
+    void setAlpha(const uint16_t channel, float alpha);
+    float getAlpha(const uint16_t channel) const;
+
+    float getValue(const uint16_t channel) const;
+    float getSlope(const uint16_t channel) const;
+    float getCurve(const uint16_t channel) const;
+    void setValue(const float value);
+    void setValue(const uint16_t channel, const float value);
+
+    void getValues(float* out) const;
+    void getSlopes(float* out) const;
+    void getCurves(float* out) const;
+
+    uint16_t getChannels() const;
+
+    EMABank& operator=(const EMABank& other);
+    EMABank& operator=(EMABank&& other) noexcept;
+
+    void swap(EMABank& other) noexcept;
+
+private:
+    static const uint8_t PLANES = 5; // alpha, beta, 3 x value
+    static const size_t ALIGN = MM_EMABANK_LANES * sizeof(float);
+
+    float* plane(const uint8_t p) const
+    {
+        return m_base + (size_t)p * m_stride;
+    }
+
+    float* alpha() const
+    {
+        return plane(0);
+    }
+
+    float* beta() const
+    {
+        return plane(1);
+    }
+
+    // age 0 is the newest value, 2 the oldest
+    float* values(const uint8_t age) const
+    {
+        return plane(2 + (m_head + 3 - age) % 3);
+    }
+
+    void allocate();
+
+    uint16_t m_channels; // number of channels
+    uint32_t m_stride; // m_channels padded to whole SIMD lanes, can exceed 65535
+    uint8_t m_head; // plane of the newest values
+    float* m_memory; // allocation
+    float* m_base; // m_memory aligned to ALIGN
+};
+
+inline EMABank::EMABank()
+    : m_channels(0)
+    , m_stride(0)
+    , m_head(0)
+    , m_memory(nullptr)
+    , m_base(nullptr)
+{
+}
+
+/**
+ * @name EMABank Constructor
+ * @param channels	number of channels
+ * @param n			period of every channel, alpha = 2 / (n + 1)
+ * @param value		initial value of every channel
+ */
+inline EMABank::EMABank(const uint16_t channels, int n, float value)
+    : m_channels(channels)
+    , m_stride(((uint32_t)channels + MM_EMABANK_LANES - 1) / MM_EMABANK_LANES * MM_EMABANK_LANES)
+    , m_head(0)
+{
+    this->allocate();
+    memset(m_base, 0, (size_t)PLANES * m_stride * sizeof(float));
+    this->setPeriod(n);
+    this->setValue(value);
+}
+
+// copy contructor
+inline EMABank::EMABank(const EMABank& other)
+    : m_channels(other.m_channels)
+    , m_stride(other.m_stride)
+    , m_head(other.m_head)
+{
+    this->allocate();
+    if (m_base) {
+        memcpy(m_base, other.m_base, (size_t)PLANES * m_stride * sizeof(float));
+    }
+}
+
+inline EMABank::EMABank(EMABank&& other) noexcept
+    : m_channels(std::exchange(other.m_channels, 0))
+    , m_stride(std::exchange(other.m_stride, 0))
+    , m_head(std::exchange(other.m_head, 0))
+    , m_memory(std::exchange(other.m_memory, nullptr))
+    , m_base(std::exchange(other.m_base, nullptr))
+{
+}
+
+inline EMABank::~EMABank()
+{
+    delete[] m_memory;
+}
+
+inline void EMABank::allocate()
+{
+    if (m_stride == 0) {
+        m_memory = nullptr;
+        m_base = nullptr;
+        return;
+    }
+
+    m_memory = new float[(size_t)PLANES * m_stride + MM_EMABANK_LANES];
+    const uintptr_t address = (uintptr_t)m_memory;
+    m_base = (float*)((address + ALIGN - 1) / ALIGN * ALIGN);
+}
+
+/**
+ * @name update
+ * @param frame		one sample per channel
+ * Computes the new value of every channel into the oldest plane, which then becomes the newest.
+ */
+inline void EMABank::update(const float* frame)
+{
+    const float* a = alpha();
+    const float* b = beta();
+    const float* prev = values(0);
+    float* next = values(2);
+
+    uint16_t c = 0;
+
+#if MM_EMABANK_LANES == 8 && defined(__AVX__)
+    for (; c + 8 <= m_channels; c += 8) {
+        const __m256 x = _mm256_loadu_ps(frame + c);
+        const __m256 v = _mm256_add_ps(_mm256_mul_ps(x, _mm256_load_ps(a + c)),
+            _mm256_mul_ps(_mm256_load_ps(prev + c), _mm256_load_ps(b + c)));
+        _mm256_store_ps(next + c, v);
+    }
+#elif MM_EMABANK_LANES >= 4 && defined(__SSE__)
+    for (; c + 4 <= m_channels; c += 4) {
+        const __m128 x = _mm_loadu_ps(frame + c);
+        const __m128 v = _mm_add_ps(_mm_mul_ps(x, _mm_load_ps(a + c)),
+            _mm_mul_ps(_mm_load_ps(prev + c), _mm_load_ps(b + c)));
+        _mm_store_ps(next + c, v);
+    }
+#endif
+
+    for (; c < m_channels; c++) {
+        next[c] = frame[c] * a[c] + prev[c] * b[c];
+    }
+
+    m_head = m_head == 2 ? 0 : m_head + 1;
+}
+
+/**
+ * @name update
+ * @param frames	count frames one after another, each with one sample per channel
+ */
+inline void EMABank::update(const float* frames, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        this->update(frames + i * m_channels);
+    }
+}
+
+inline void EMABank::setPeriod(int n)
+{
+    for (uint16_t c = 0; c < m_channels; c++) {
+        this->setPeriod(c, n);
+    }
+}
+
+inline void EMABank::setPeriod(const uint16_t channel, int n)
+{
+    this->setAlpha(channel, 2.0f / ((n < 1 ? 1 : n) + 1));
+}
+
+inline void EMABank::setAlpha(const uint16_t channel, float a)
+{
+    alpha()[channel] = a > 1.0f ? 1.0f : (a < 0.0f ? 0.0f : a);
+    beta()[channel] = 1.0f - alpha()[channel];
+}
+
+inline float EMABank::getAlpha(const uint16_t channel) const
+{
+    return alpha()[channel];
+}
+
+inline float EMABank::getValue(const uint16_t channel) const
+{
+    return values(0)[channel];
+}
+
+inline float EMABank::getSlope(const uint16_t channel) const
+{
+    return values(0)[channel] - values(1)[channel];
+}
+
+inline float EMABank::getCurve(const uint16_t channel) const
+{
+    return (values(0)[channel] - values(1)[channel]) - (values(1)[channel] - values(2)[channel]);
+}
+
+inline void EMABank::setValue(const float value)
+{
+    for (uint16_t c = 0; c < m_channels; c++) {
+        this->setValue(c, value);
+    }
+}
+
+inline void EMABank::setValue(const uint16_t channel, const float value)
+{
+    for (uint8_t age = 0; age < 3; age++) {
+        values(age)[channel] = value;
+    }
+}
+
+inline void EMABank::getValues(float* out) const
+{
+    memcpy(out, values(0), m_channels * sizeof(float));
+}
+
+inline void EMABank::getSlopes(float* out) const
+{
+    const float* v0 = values(0);
+    const float* v1 = values(1);
+    for (uint16_t c = 0; c < m_channels; c++) {
+        out[c] = v0[c] - v1[c];
+    }
+}
+
+inline void EMABank::getCurves(float* out) const
+{
+    const float* v0 = values(0);
+    const float* v1 = values(1);
+    const float* v2 = values(2);
+    for (uint16_t c = 0; c < m_channels; c++) {
+        out[c] = (v0[c] - v1[c]) - (v1[c] - v2[c]);
+    }
+}
+
+inline uint16_t EMABank::getChannels() const
+{
+    return m_channels;
+}
+
+// copy assignment
+inline EMABank& EMABank::operator=(const EMABank& other)
+{
+    if (this != &other) {
+        EMABank(other).swap(*this); // Copy-constructor and non-throwing swap
+    }
+
+    return *this;
+}
+
+// move assignment
+inline EMABank& EMABank::operator=(EMABank&& other) noexcept
+{
+    // Guard self assignment
+    if (this == &other)
+        return *this;
+
+    delete[] m_memory;
+
+    m_channels = std::exchange(other.m_channels, 0);
+    m_stride = std::exchange(other.m_stride, 0);
+    m_head = std::exchange(other.m_head, 0);
+    m_memory = std::exchange(other.m_memory, nullptr);
+    m_base = std::exchange(other.m_base, nullptr);
+
+    return *this;
+}
+
+inline void EMABank::swap(EMABank& other) noexcept
+{
+    std::swap(this->m_channels, other.m_channels);
+    std::swap(this->m_stride, other.m_stride);
+    std::swap(this->m_head, other.m_head);
+    std::swap(this->m_memory, other.m_memory);
+    std::swap(this->m_base, other.m_base);
+}
+
+#endif
@@ -41,121 +41,465 @@
 #ifndef _MM_MAVERAGE_H
 #define _MM_MAVERAGE_H
 
-#include <Arduino.h>
+#include "MakerMatty_Platform.h"
 
-#include "stl_exchange.h"
+#include <new>
+#include <type_traits>
+
+// bytes of values MA<T> keeps inside the object before it allocates its array
+#ifndef MM_MA_INLINE_BYTES
+#define MM_MA_INLINE_BYTES 32
+#endif
 
 /**
- * Moving Average Class as acc_data template for non floating point values
+ * Accumulator of the running sum, selected per T at compile time
+ * int32_t for 8 bit and int16_t values and uint32_t for uint16_t values, exact over 65535
+ * entries and native on 32 bit targets (the ESP32 has no 64 bit adds or multiplies),
+ * int64_t for wider integer values (no overflow of 32 bit values summed over 65535 entries),
+ * double for floating point values (no truncation of the fraction).
+ * Pass another type as the second template argument of MA / third of MATemplated,
+ * or specialize for custom value types.
  */
+template <class T, bool = std::is_floating_point<T>::value, bool = std::is_integral<T>::value && sizeof(T) <= 2>
+struct MAAccumulator {
+    typedef int64_t type;
+};
+
+template <class T>
+struct MAAccumulator<T, true, false> {
+    typedef double type;
+};
+
 template <class T>
+struct MAAccumulator<T, false, true> {
+    // 65535 * 65535 does not fit int32_t, 65535 * 32768 and 65535 * 255 do
+    typedef typename std::conditional<sizeof(T) == 2 && !std::is_signed<T>::value, uint32_t, int32_t>::type type;
+};
+
+/**
+ * Division of the running sum by the number of entries without a divide instruction
+ * For integer accumulators the divisor is turned into a fixed-point reciprocal once
+ * (libdivide style magic number, round-up variant) and every division becomes a high
+ * multiply and a shift, or just a shift when the divisor is a power of two. Accumulators
+ * up to 32 bit use a 32 bit magic and a 32x32 high multiply (one instruction on the ESP32),
+ * wider ones a 64 bit magic and a 64x64 high multiply.
+ * The quotient is exact and truncates toward zero like the / operator.
+ * The constructor is constexpr, so a compile-time divisor costs nothing at runtime.
+ * Floating point accumulators keep the true division, a reciprocal would change rounding.
+ */
+template <class A, bool = std::is_integral<A>::value>
+class MADivider {
+    typedef typename std::conditional<(sizeof(A) <= 4), uint32_t, uint64_t>::type U;
+    static const uint8_t BITS = sizeof(U) * 8;
+
+public:
+    constexpr MADivider(const uint16_t d = 1)
+        : m_magic(magic(d == 0 ? 1 : d))
+        , m_shift(floorLog2(d == 0 ? 1 : d))
+        , m_add(!isPow2(d == 0 ? 1 : d) && needsAdd(d == 0 ? 1 : d))
+    {
+    }
+
+    void setDivisor(const uint16_t d)
+    {
+        *this = MADivider(d);
+    }
+
+    A divide(const A n) const
+    {
+        if (std::is_signed<A>::value) {
+            const A sign = n < 0 ? (A)-1 : (A)0;
+            const U q = this->divideUnsigned((U)(n ^ sign) - (U)sign);
+            return (A)((q ^ (U)sign) - (U)sign);
+        }
+        return (A)this->divideUnsigned((U)n);
+    }
+
+private:
+    U divideUnsigned(const U n) const
+    {
+        if (!m_magic) {
+            return n >> m_shift;
+        }
+        const U q = mulhi(m_magic, n);
+        return m_add ? (((n - q) >> 1) + q) >> m_shift : q >> m_shift;
+    }
+
+    static uint32_t mulhi(const uint32_t a, const uint32_t b)
+    {
+        return (uint32_t)(((uint64_t)a * b) >> 32);
+    }
+
+    static uint64_t mulhi(const uint64_t a, const uint64_t b)
+    {
+#if defined(__SIZEOF_INT128__)
+        return (uint64_t)(((unsigned __int128)a * b) >> 64);
+#else
+        const uint64_t a0 = (uint32_t)a, a1 = a >> 32;
+        const uint64_t b0 = (uint32_t)b, b1 = b >> 32;
+        const uint64_t p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+        const uint64_t mid = (p00 >> 32) + (uint32_t)p01 + (uint32_t)p10;
+        return p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+#endif
+    }
+
+    // single expression helpers to stay constexpr in C++11, d is not 0
+    static constexpr bool isPow2(const uint16_t d)
+    {
+        return (d & (d - 1)) == 0;
+    }
+
+    static constexpr uint8_t floorLog2(const uint16_t d)
+    {
+        return d < 2 ? 0 : 1 + floorLog2(d >> 1);
+    }
+
+    // 2^(BITS + floorLog2(d)) / d by long division in 32 bit limbs, d is not a power of two
+    static constexpr uint64_t partialRemainder(const uint16_t d)
+    {
+        return ((uint64_t)1 << (32 + floorLog2(d))) % d;
+    }
+
+    static constexpr U quotient(const uint16_t d)
+    {
+        return BITS == 32 ? (U)(((uint64_t)1 << (32 + floorLog2(d))) / d)
+                          : (U)(((((uint64_t)1 << (32 + floorLog2(d))) / d) << 32) | ((partialRemainder(d) << 32) / d));
+    }
+
+    static constexpr uint64_t remainder(const uint16_t d)
+    {
+        return BITS == 32 ? partialRemainder(d) : (partialRemainder(d) << 32) % d;
+    }
+
+    // magic would need BITS + 1 bits, keep BITS and compensate in divideUnsigned()
+    static constexpr bool needsAdd(const uint16_t d)
+    {
+        return d - remainder(d) >= ((uint64_t)1 << floorLog2(d));
+    }
+
+    static constexpr U magic(const uint16_t d)
+    {
+        return isPow2(d) ? 0
+            : needsAdd(d) ? (U)(quotient(d) * (U)2 + (remainder(d) * 2 >= d ? 1 : 0) + 1)
+                          : (U)(quotient(d) + 1);
+    }
+
+    U m_magic; // 0 when the divisor is a power of two
+    uint8_t m_shift;
+    bool m_add;
+};
+
+template <class A>
+class MADivider<A, false> {
+
+public:
+    constexpr MADivider(const uint16_t d = 1)
+        : m_divisor(d == 0 ? 1 : d)
+    {
+    }
+
+    void setDivisor(const uint16_t d)
+    {
+        m_divisor = d == 0 ? 1 : d;
+    }
+
+    A divide(const A n) const
+    {
+        return n / m_divisor;
+    }
+
+private:
+    A m_divisor;
+};
+
+/**
+ * Memory resource for the arrays of MA
+ * The std::pmr::memory_resource idea without needing C++17, so filters can draw from
+ * static pools, secondary RAM regions or per-request arenas instead of the global heap.
+ * allocate() returns nullptr when the resource is exhausted.
+ */
+class MAMemoryResource {
+
+public:
+    virtual ~MAMemoryResource() { }
+
+    virtual void* allocate(const size_t bytes, const size_t align) = 0;
+    virtual void deallocate(void* p, const size_t bytes, const size_t align) = 0;
+};
+
+/**
+ * Global heap, what MA uses when no resource is given
+ * Allocates without throwing, so running out of memory takes MA's inline fallback.
+ */
+class MAHeapResource : public MAMemoryResource {
+
+public:
+    void* allocate(const size_t bytes, const size_t) override
+    {
+        return ::operator new(bytes, std::nothrow);
+    }
+
+    void deallocate(void* p, const size_t, const size_t) override
+    {
+        ::operator delete(p);
+    }
+
+    static MAHeapResource* instance()
+    {
+        static MAHeapResource resource;
+        return &resource;
+    }
+};
+
+/**
+ * Arena over a caller-owned buffer
+ * Hands out consecutive aligned chunks, deallocate() is a no-op and reset() releases
+ * everything at once, e.g. when the connection or request the filters belong to ends.
+ */
+class MAArenaResource : public MAMemoryResource {
+
+public:
+    MAArenaResource(void* buffer, const size_t size)
+        : m_buffer((uint8_t*)buffer)
+        , m_size(size)
+        , m_used(0)
+    {
+    }
+
+    void* allocate(const size_t bytes, const size_t align) override
+    {
+        const uintptr_t base = (uintptr_t)m_buffer;
+        const size_t offset = (size_t)((base + m_used + align - 1) / align * align - base);
+        if (offset > m_size || bytes > m_size - offset) {
+            return nullptr;
+        }
+        m_used = offset + bytes;
+        return m_buffer + offset;
+    }
+
+    void deallocate(void*, const size_t, const size_t) override
+    {
+    }
+
+    void reset()
+    {
+        m_used = 0;
+    }
+
+    size_t getUsed() const
+    {
+        return m_used;
+    }
+
+private:
+    uint8_t* m_buffer;
+    size_t m_size;
+    size_t m_used;
+};
+
+/**
+ * Moving Average Class as acc_data template for non floating point values
+ */
+template <class T, class A = typename MAAccumulator<T>::type>
 class MA {
 
 public:
     MA();
-    MA(const uint16_t n, T init = 0);
-    MA(const MA<T>& other); // copy contructor
-    MA(MA<T>&& other)
+    MA(const uint16_t n, T init = 0, MAMemoryResource* resource = nullptr);
+    MA(T* buffer, const uint16_t n, T init = 0);
+    MA(const MA<T, A>& other); // copy contructor
+    MA(MA<T, A>&& other)
     noexcept; // move contructor
     ~MA();
 
     T update(const T);
+    T update(const T* in, size_t count, T* out = nullptr);
     T getValue() const;
     void setValue(const T m_value);
+    uint16_t getSize() const;
 
     // const T& Value = m_value;
 
-    MA<T>& operator=(const MA<T>& other);
-    MA<T>& operator=(MA<T>&& other) noexcept;
+    MA<T, A>& operator=(const MA<T, A>& other);
+    MA<T, A>& operator=(MA<T, A>&& other) noexcept;
 
-    void swap(MA<T>& other) noexcept;
+    void swap(MA<T, A>& other) noexcept;
+
+    // values kept inside the object, larger windows allocate
+    static const uint16_t INLINE_N = MM_MA_INLINE_BYTES / sizeof(T) ? MM_MA_INLINE_BYTES / sizeof(T) : 1;
 
 private:
+    void acquire(const uint16_t n, MAMemoryResource* resource);
+    void release();
+    void fill(T init);
+
     uint16_t m_n; // number of elements in our array
+    MADivider<A> m_divider; // division by m_n
     T* m_data; // Type pointer elements in our array
+    MAMemoryResource* m_resource; // owner of m_data, nullptr when inline or the caller owns it
     uint16_t m_index; // current m_index
-    int32_t m_sum; // m_sum for rest
+    A m_sum; // m_sum for rest
     bool m_filled; // used to determine if we went through the whole array
     T m_value = 0;
+    T m_inline[INLINE_N]; // m_data of small windows
 };
 
-template <class T>
-MA<T>::MA()
-    : m_n(1)
-    , m_data(nullptr)
-    , m_index(0)
+template <class T, class A>
+MA<T, A>::MA()
+    : m_index(0)
     , m_sum(0)
     , m_filled(false)
     , m_value(0)
 {
+    this->acquire(1, nullptr);
+    this->fill(0);
 }
 
 /**
  * @name MA Constructor
  * @param numberOf_data number of m_data in the array
+ * @param resource	where the array comes from, the global heap when nullptr
  * Creates dynamically an array of our type values and initializes the array
  * and some local variables. There is no destructor as this is quite useless
  * due to lack of garbage collection in Arduino
+ * Arrays of up to INLINE_N values live inside the object and allocate nothing.
+ * If the resource is exhausted the MA is left with a single entry, like MA().
  */
-template <class T>
-MA<T>::MA(const uint16_t n, T init)
-    : m_n(n == 0 ? 1 : n)
-    , m_data(new T[m_n])
-    , m_index(0)
+template <class T, class A>
+MA<T, A>::MA(const uint16_t n, T init, MAMemoryResource* resource)
+    : m_index(0)
 {
     if (n == 0) {
         log_e("n must not be 0");
     }
 
-    if (init != 0) {
-        for (size_t i = 0; i < m_n; i++) {
-            m_data[i] = init;
-        }
-        m_sum = init * m_n;
-        m_filled = true;
-        m_value = init;
-    } else {
-        memset(m_data, 0, m_n * sizeof(T));
-        m_sum = 0;
-        m_filled = false;
-        m_value = 0;
+    this->acquire(n == 0 ? 1 : n, resource);
+    this->fill(init);
+}
+
+/**
+ * @name MA Constructor
+ * @param buffer	caller-owned array of n values (static pool, secondary RAM), must outlive the MA
+ * @param n			number of values in buffer
+ * The buffer is never freed by the MA. Copies of this MA use their own array.
+ * Without a buffer the MA never touches the heap, it falls back to a single inline entry.
+ */
+template <class T, class A>
+MA<T, A>::MA(T* buffer, const uint16_t n, T init)
+    : m_n(n == 0 ? 1 : n)
+    , m_divider(m_n)
+    , m_data(buffer)
+    , m_resource(nullptr)
+    , m_index(0)
+{
+    if (n == 0 || !buffer) {
+        log_e("buffer of n values required");
+        m_n = 1;
+        m_divider = MADivider<A>(m_n);
+        m_data = m_inline;
     }
+
+    this->fill(init);
 }
 
 // copy contructor
-template <class T>
-MA<T>::MA(const MA<T>& other)
-    : m_n(other.m_n)
-    , m_data(new T[other.m_n])
-    , m_index(other.m_index)
+template <class T, class A>
+MA<T, A>::MA(const MA<T, A>& other)
+    : m_index(other.m_index)
     , m_sum(other.m_sum)
     , m_filled(other.m_filled)
     , m_value(other.m_value)
 {
-    memcpy(m_data, other.m_data, other.m_n * sizeof(T));
+    this->acquire(other.m_n, other.m_resource);
+
+    if (m_n == other.m_n) {
+        memcpy(m_data, other.m_data, other.m_n * sizeof(T));
+    } else {
+        m_index = 0;
+        this->fill(0);
+    }
 }
 
-template <class T>
-MA<T>::MA(MA<T>&& other) noexcept
+template <class T, class A>
+MA<T, A>::MA(MA<T, A>&& other) noexcept
     // , class(std::move(other.class)) // explicit move of a member of class type
     // , variable(std::exchange(other.variable, 0)) // explicit move of a member of non-class type
     : m_n(std::exchange(other.m_n, 0))
+    , m_divider(other.m_divider)
     , m_data(std::exchange(other.m_data, nullptr))
+    , m_resource(std::exchange(other.m_resource, nullptr))
     , m_index(std::exchange(other.m_index, 0))
     , m_sum(std::exchange(other.m_sum, 0))
     , m_filled(std::exchange(other.m_filled, false))
     , m_value(std::exchange(other.m_value, 0))
 {
+    if (m_data == other.m_inline) {
+        memcpy(m_inline, other.m_inline, m_n * sizeof(T));
+        m_data = m_inline;
+    }
 }
 
 /**
  * @name ~MA Constructor
  * frees dynamic allocated memory
  */
-template <class T>
-MA<T>::~MA()
+template <class T, class A>
+MA<T, A>::~MA()
+{
+    this->release();
+}
+
+/**
+ * @name acquire
+ * Points m_data to the inline array when n fits, otherwise allocates it from the resource
+ * (global heap when nullptr). Falls back to a single inline entry when out of memory,
+ * getSize() then returns 1.
+ */
+template <class T, class A>
+void MA<T, A>::acquire(const uint16_t n, MAMemoryResource* resource)
+{
+    m_n = n;
+    m_data = m_inline;
+    m_resource = nullptr;
+
+    if (n > INLINE_N) {
+        m_resource = resource ? resource : MAHeapResource::instance();
+        m_data = (T*)m_resource->allocate(n * sizeof(T), alignof(T));
+        if (!m_data) {
+            log_e("out of memory");
+            m_n = 1;
+            m_data = m_inline;
+            m_resource = nullptr;
+        }
+    }
+
+    m_divider = MADivider<A>(m_n);
+}
+
+template <class T, class A>
+void MA<T, A>::release()
+{
+    if (m_resource && m_data) {
+        m_resource->deallocate(m_data, m_n * sizeof(T), alignof(T));
+    }
+}
+
+template <class T, class A>
+void MA<T, A>::fill(T init)
 {
-    delete[] m_data;
+    if (init != 0) {
+        for (size_t i = 0; i < m_n; i++) {
+            m_data[i] = init;
+        }
+        m_sum = (A)init * m_n;
+        m_filled = true;
+        m_value = init;
+    } else {
+        memset(m_data, 0, m_n * sizeof(T));
+        m_sum = 0;
+        m_filled = false;
+        m_value = 0;
+    }
 }
 
 /**
@@ -166,20 +510,75 @@ MA<T>::~MA()
  * amount of entries. This function keeps track of this situation and calculates the correct
  * average on the number of items listed.
  */
-template <class T>
-T MA<T>::update(const T val)
+template <class T, class A>
+T MA<T, A>::update(const T val)
 {
     if (m_index >= m_n) {
         m_index = 0; // reset m_index
         m_filled = true; // we looped through at least once
     }
 
-    m_sum = m_sum - (int32_t)m_data[m_index] + (int32_t)val;
+    m_sum = m_sum - (A)m_data[m_index] + (A)val;
 
     m_data[m_index] = val;
     ++m_index;
 
-    m_value = m_filled ? (T)(m_sum / (int32_t)m_n) : (T)(m_sum / (int32_t)m_index);
+    m_value = m_filled ? (T)m_divider.divide(m_sum) : (T)(m_sum / (A)m_index);
+
+    return m_value;
+}
+
+/**
+ * @name update
+ * @param in	block of count values to be added to the array
+ * @param out	optional, receives the moving average after every value (must not overlap in)
+ * @returns T returns the new moving average.
+ * Same results as calling update(T) for every value. The block is split at the wrap point
+ * of m_data, every run is summed in one sweep and copied into m_data with a single memcpy.
+ */
+template <class T, class A>
+T MA<T, A>::update(const T* in, size_t count, T* out)
+{
+    if (count == 0) {
+        return m_value;
+    }
+
+    while (count > 0) {
+        if (m_index >= m_n) {
+            m_index = 0; // reset m_index
+            m_filled = true; // we looped through at least once
+        }
+
+        const uint16_t run = count < (size_t)(m_n - m_index) ? (uint16_t)count : (uint16_t)(m_n - m_index);
+        const T* old = m_data + m_index;
+        A sum = m_sum;
+
+        if (!out) {
+            for (uint16_t i = 0; i < run; i++) {
+                sum = sum - (A)old[i] + (A)in[i];
+            }
+        } else if (m_filled) {
+            for (uint16_t i = 0; i < run; i++) {
+                sum = sum - (A)old[i] + (A)in[i];
+                out[i] = (T)m_divider.divide(sum);
+            }
+            out += run;
+        } else {
+            for (uint16_t i = 0; i < run; i++) {
+                sum = sum - (A)old[i] + (A)in[i];
+                out[i] = (T)(sum / (A)(m_index + i + 1));
+            }
+            out += run;
+        }
+
+        memcpy(m_data + m_index, in, run * sizeof(T));
+        m_sum = sum;
+        m_index += run;
+        in += run;
+        count -= run;
+    }
+
+    m_value = m_filled ? (T)m_divider.divide(m_sum) : (T)(m_sum / (A)m_index);
 
     return m_value;
 }
@@ -191,8 +590,8 @@ T MA<T>::update(const T val)
  * amount of entries. This function keeps track of this situation and calculates the correct
  * average on the number of items listed.
  */
-template <class T>
-T MA<T>::getValue() const
+template <class T, class A>
+T MA<T, A>::getValue() const
 {
     return m_value;
 }
@@ -204,24 +603,35 @@ T MA<T>::getValue() const
  * amount of entries. This function keeps track of this situation and calculates the correct
  * average on the number of items listed.
  */
-template <class T>
-void MA<T>::setValue(const T val)
+template <class T, class A>
+void MA<T, A>::setValue(const T val)
 {
     for (size_t i = 0; i < m_n; i++) {
         m_data[i] = val;
     }
-    m_sum = val * m_n;
+    m_sum = (A)val * m_n;
     m_filled = true;
     m_value = val;
 }
 
+/**
+ * @name getSize
+ * @returns uint16_t number of values averaged once the window is full. 1 when the window
+ * could not be allocated (see acquire), compare it with the n given to the constructor.
+ */
+template <class T, class A>
+uint16_t MA<T, A>::getSize() const
+{
+    return m_n;
+}
+
 // copy assignment
 
-template <class T>
-MA<T>& MA<T>::operator=(const MA<T>& other)
+template <class T, class A>
+MA<T, A>& MA<T, A>::operator=(const MA<T, A>& other)
 {
     if (this != &other) {
-        MA<T>(other).swap(*this); // Copy-constructor and non-throwing swap
+        MA<T, A>(other).swap(*this); // Copy-constructor and non-throwing swap
     }
 
     // Old resources are released with the destruction of the temporary above
@@ -229,32 +639,201 @@ MA<T>& MA<T>::operator=(const MA<T>& other)
 }
 
 // move assignment
-template <class T>
-MA<T>& MA<T>::operator=(MA<T>&& other) noexcept
+template <class T, class A>
+MA<T, A>& MA<T, A>::operator=(MA<T, A>&& other) noexcept
 {
     // Guard self assignment
     if (this == &other)
         return *this;
 
+    this->release();
+
     m_n = std::exchange(other.m_n, 0);
+    m_divider = other.m_divider;
     m_data = std::exchange(other.m_data, nullptr);
+    m_resource = std::exchange(other.m_resource, nullptr);
     m_index = std::exchange(other.m_index, 0);
     m_sum = std::exchange(other.m_sum, 0);
     m_filled = std::exchange(other.m_filled, false);
     m_value = std::exchange(other.m_value, 0);
 
+    if (m_data == other.m_inline) {
+        memcpy(m_inline, other.m_inline, m_n * sizeof(T));
+        m_data = m_inline;
+    }
+
     return *this;
 }
 
-template <class T>
-void MA<T>::swap(MA<T>& other) noexcept // Also see non-throwing swap idiom
+template <class T, class A>
+void MA<T, A>::swap(MA<T, A>& other) noexcept // Also see non-throwing swap idiom
 {
+    const bool inlined = m_data == m_inline;
+    const bool otherInlined = other.m_data == other.m_inline;
+
     std::swap(this->m_n, other.m_n);
+    std::swap(this->m_divider, other.m_divider);
     std::swap(this->m_data, other.m_data);
+    std::swap(this->m_resource, other.m_resource);
     std::swap(this->m_index, other.m_index);
     std::swap(this->m_sum, other.m_sum);
     std::swap(this->m_filled, other.m_filled);
     std::swap(this->m_value, other.m_value);
+
+    // inline arrays travel with their contents
+    if (inlined || otherInlined) {
+        for (uint16_t i = 0; i < INLINE_N; i++) {
+            std::swap(this->m_inline[i], other.m_inline[i]);
+        }
+        if (otherInlined) {
+            this->m_data = this->m_inline;
+        }
+        if (inlined) {
+            other.m_data = other.m_inline;
+        }
+    }
+}
+
+/**
+ * Moving Average Class with the number of entries known at compile time
+ * Behaves like MA<T>(N, init) but keeps the array inline (no heap, can live in static memory),
+ * divides by N with a compile-time reciprocal multiply or shift (MADivider) and wraps
+ * the index by masking when N is a power of two.
+ */
+template <class T, uint16_t N, class A = typename MAAccumulator<T>::type>
+class MATemplated {
+    static_assert(N > 0, "N must not be 0");
+
+public:
+    MATemplated(T init = 0);
+
+    T update(const T);
+    T update(const T* in, size_t count, T* out = nullptr);
+    T getValue() const;
+    void setValue(const T m_value);
+
+private:
+    static constexpr bool POW2 = (N & (N - 1)) == 0;
+    static constexpr MADivider<A> DIVIDER = MADivider<A>(N);
+
+    static uint16_t next(const uint16_t index)
+    {
+        return POW2 ? (uint16_t)((index + 1) & (N - 1)) : (uint16_t)(index + 1 == N ? 0 : index + 1);
+    }
+
+    T m_data[N]; // elements in our array
+    uint16_t m_index; // slot the next value goes to
+    uint16_t m_count; // number of values in the array, N once filled
+    A m_sum; // m_sum for rest
+    T m_value;
+};
+
+template <class T, uint16_t N, class A>
+constexpr MADivider<A> MATemplated<T, N, A>::DIVIDER;
+
+template <class T, uint16_t N, class A>
+MATemplated<T, N, A>::MATemplated(T init)
+    : m_index(0)
+{
+    if (init != 0) {
+        this->setValue(init);
+    } else {
+        memset(m_data, 0, sizeof(m_data));
+        m_count = 0;
+        m_sum = 0;
+        m_value = 0;
+    }
+}
+
+/**
+ * @name update
+ * @param m_value	m_value to be added to array
+ * @returns T returns the new moving average.
+ * Once filled the division is by the constant N, see MADivider.
+ */
+template <class T, uint16_t N, class A>
+T MATemplated<T, N, A>::update(const T val)
+{
+    m_sum = m_sum - (A)m_data[m_index] + (A)val;
+
+    m_data[m_index] = val;
+    m_index = next(m_index);
+
+    if (m_count < N) {
+        ++m_count;
+        return m_value = (T)(m_sum / (A)m_count);
+    }
+
+    return m_value = (T)DIVIDER.divide(m_sum);
+}
+
+/**
+ * @name update
+ * @param in	block of count values to be added to the array
+ * @param out	optional, receives the moving average after every value (must not overlap in)
+ * @returns T returns the new moving average.
+ * Same results as calling update(T) for every value, see MA<T>::update(const T*, size_t, T*).
+ */
+template <class T, uint16_t N, class A>
+T MATemplated<T, N, A>::update(const T* in, size_t count, T* out)
+{
+    if (count == 0) {
+        return m_value;
+    }
+
+    while (count > 0) {
+        const uint16_t run = count < (size_t)(N - m_index) ? (uint16_t)count : (uint16_t)(N - m_index);
+        const T* old = m_data + m_index;
+        A sum = m_sum;
+        uint16_t i = 0;
+
+        // filling, averaged over the values seen so far
+        for (; i < run && m_count < N; i++) {
+            sum = sum - (A)old[i] + (A)in[i];
+            ++m_count;
+            if (out) {
+                *out++ = (T)(sum / (A)m_count);
+            }
+        }
+
+        if (!out) {
+            for (; i < run; i++) {
+                sum = sum - (A)old[i] + (A)in[i];
+            }
+        } else {
+            for (; i < run; i++) {
+                sum = sum - (A)old[i] + (A)in[i];
+                *out++ = (T)DIVIDER.divide(sum);
+            }
+        }
+
+        memcpy(m_data + m_index, in, run * sizeof(T));
+        m_sum = sum;
+        m_index = (uint16_t)(m_index + run) == N ? 0 : (uint16_t)(m_index + run);
+        in += run;
+        count -= run;
+    }
+
+    m_value = m_count == N ? (T)DIVIDER.divide(m_sum) : (T)(m_sum / (A)m_count);
+
+    return m_value;
+}
+
+template <class T, uint16_t N, class A>
+T MATemplated<T, N, A>::getValue() const
+{
+    return m_value;
+}
+
+template <class T, uint16_t N, class A>
+void MATemplated<T, N, A>::setValue(const T val)
+{
+    for (size_t i = 0; i < N; i++) {
+        m_data[i] = val;
+    }
+    m_sum = (A)val * N;
+    m_count = N;
+    m_value = val;
 }
 
 // // copy assignment
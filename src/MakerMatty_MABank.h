@@ -0,0 +1,265 @@
+/**
+ * Author	: @makermatty (maker.matejsuchanek.cz)
+ * Date		: 15-10-2026
+ *
+ * Multi-channel Moving Average Class
+ * One MA<T> per channel sharing a single allocation: the running sums, the averages and
+ * the ring buffers of all channels interleaved frame by frame (frame-major), so a frame
+ * update reads and writes one contiguous row, one index serves every channel and the sum
+ * loop vectorizes. The division uses one MADivider for all channels, also while filling.
+ * Every channel gives the same averages as an MA<T, A> with the same n.
+ */
+
+#ifndef _MM_MABANK_H
+#define _MM_MABANK_H
+
+#include "MakerMatty_MA.h"
+
+template <class T, class A = typename MAAccumulator<T>::type>
+class MABank {
+    static_assert(alignof(T) <= alignof(A), "values are stored behind the sums");
+
+public:
+    MABank();
+    MABank(const uint16_t channels, const uint16_t n, T init = 0);
+    MABank(const MABank<T, A>& other); // copy contructor
+    MABank(MABank<T, A>&& other) noexcept; // move contructor
+    ~MABank();
+
+    void update(const T* frame);
+    void update(const T* frames, size_t count);
+
+    T getValue(const uint16_t channel) const;
+    void getValues(T* out) const;
+    const T* getValues() const;
+    void setValue(const T val);
+
+    uint16_t getChannels() const;
+
+    MABank<T, A>& operator=(const MABank<T, A>& other);
+    MABank<T, A>& operator=(MABank<T, A>&& other) noexcept;
+
+    void swap(MABank<T, A>& other) noexcept;
+
+private:
+    // sums, values and the ring rounded up to whole accumulators
+    size_t words() const
+    {
+        return m_channels + ((size_t)m_channels * (1 + m_n) * sizeof(T) + sizeof(A) - 1) / sizeof(A);
+    }
+
+    A* sums() const
+    {
+        return m_memory;
+    }
+
+    T* values() const
+    {
+        return (T*)(m_memory + m_channels);
+    }
+
+    T* ring() const
+    {
+        return values() + m_channels;
+    }
+
+    uint16_t m_channels; // number of channels
+    uint16_t m_n; // number of frames in the ring
+    MADivider<A> m_divider; // division by m_n
+    uint16_t m_index; // current m_index
+    bool m_filled; // used to determine if we went through the whole ring
+    A* m_memory; // sums, values, ring
+};
+
+template <class T, class A>
+MABank<T, A>::MABank()
+    : m_channels(0)
+    , m_n(1)
+    , m_divider(1)
+    , m_index(0)
+    , m_filled(false)
+    , m_memory(nullptr)
+{
+}
+
+/**
+ * @name MABank Constructor
+ * @param channels	number of channels
+ * @param n			number of frames averaged
+ * @param init		initial value of every channel, fills the window when not 0 (as MA)
+ */
+template <class T, class A>
+MABank<T, A>::MABank(const uint16_t channels, const uint16_t n, T init)
+    : m_channels(channels)
+    , m_n(n == 0 ? 1 : n)
+    , m_divider(m_n)
+    , m_index(0)
+    , m_filled(false)
+    , m_memory(new A[words()])
+{
+    if (n == 0) {
+        log_e("n must not be 0");
+    }
+
+    if (init != 0) {
+        this->setValue(init);
+    } else {
+        memset(m_memory, 0, words() * sizeof(A));
+    }
+}
+
+// copy contructor
+template <class T, class A>
+MABank<T, A>::MABank(const MABank<T, A>& other)
+    : m_channels(other.m_channels)
+    , m_n(other.m_n)
+    , m_divider(other.m_divider)
+    , m_index(other.m_index)
+    , m_filled(other.m_filled)
+    , m_memory(other.m_memory ? new A[other.words()] : nullptr)
+{
+    if (m_memory) {
+        memcpy(m_memory, other.m_memory, words() * sizeof(A));
+    }
+}
+
+template <class T, class A>
+MABank<T, A>::MABank(MABank<T, A>&& other) noexcept
+    : m_channels(std::exchange(other.m_channels, 0))
+    , m_n(std::exchange(other.m_n, 1))
+    , m_divider(other.m_divider)
+    , m_index(std::exchange(other.m_index, 0))
+    , m_filled(std::exchange(other.m_filled, false))
+    , m_memory(std::exchange(other.m_memory, nullptr))
+{
+}
+
+template <class T, class A>
+MABank<T, A>::~MABank()
+{
+    delete[] m_memory;
+}
+
+/**
+ * @name update
+ * @param frame		one value per channel
+ * Replaces the oldest row of the ring with the frame and updates every channel's average.
+ */
+template <class T, class A>
+void MABank<T, A>::update(const T* frame)
+{
+    if (m_index >= m_n) {
+        m_index = 0; // reset m_index
+        m_filled = true; // we looped through at least once
+    }
+
+    A* sum = sums();
+    T* value = values();
+    T* row = ring() + (size_t)m_index * m_channels;
+    ++m_index;
+
+    for (uint16_t c = 0; c < m_channels; c++) {
+        sum[c] = sum[c] - (A)row[c] + (A)frame[c];
+    }
+    memcpy(row, frame, m_channels * sizeof(T));
+
+    // while filling the divisor changes every frame, still shared by all channels
+    const MADivider<A> divider = m_filled ? m_divider : MADivider<A>(m_index);
+    for (uint16_t c = 0; c < m_channels; c++) {
+        value[c] = (T)divider.divide(sum[c]);
+    }
+}
+
+/**
+ * @name update
+ * @param frames	count frames one after another, each with one value per channel
+ */
+template <class T, class A>
+void MABank<T, A>::update(const T* frames, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        this->update(frames + i * m_channels);
+    }
+}
+
+template <class T, class A>
+T MABank<T, A>::getValue(const uint16_t channel) const
+{
+    return values()[channel];
+}
+
+template <class T, class A>
+void MABank<T, A>::getValues(T* out) const
+{
+    memcpy(out, values(), m_channels * sizeof(T));
+}
+
+template <class T, class A>
+const T* MABank<T, A>::getValues() const
+{
+    return values();
+}
+
+template <class T, class A>
+void MABank<T, A>::setValue(const T val)
+{
+    T* ring = this->ring();
+    for (size_t i = 0; i < (size_t)m_n * m_channels; i++) {
+        ring[i] = val;
+    }
+    for (uint16_t c = 0; c < m_channels; c++) {
+        sums()[c] = (A)val * m_n;
+        values()[c] = val;
+    }
+    m_filled = true;
+}
+
+template <class T, class A>
+uint16_t MABank<T, A>::getChannels() const
+{
+    return m_channels;
+}
+
+// copy assignment
+template <class T, class A>
+MABank<T, A>& MABank<T, A>::operator=(const MABank<T, A>& other)
+{
+    if (this != &other) {
+        MABank<T, A>(other).swap(*this); // Copy-constructor and non-throwing swap
+    }
+
+    return *this;
+}
+
+// move assignment
+template <class T, class A>
+MABank<T, A>& MABank<T, A>::operator=(MABank<T, A>&& other) noexcept
+{
+    // Guard self assignment
+    if (this == &other)
+        return *this;
+
+    delete[] m_memory;
+
+    m_channels = std::exchange(other.m_channels, 0);
+    m_n = std::exchange(other.m_n, 1);
+    m_divider = other.m_divider;
+    m_index = std::exchange(other.m_index, 0);
+    m_filled = std::exchange(other.m_filled, false);
+    m_memory = std::exchange(other.m_memory, nullptr);
+
+    return *this;
+}
+
+template <class T, class A>
+void MABank<T, A>::swap(MABank<T, A>& other) noexcept
+{
+    std::swap(this->m_channels, other.m_channels);
+    std::swap(this->m_n, other.m_n);
+    std::swap(this->m_divider, other.m_divider);
+    std::swap(this->m_index, other.m_index);
+    std::swap(this->m_filled, other.m_filled);
+    std::swap(this->m_memory, other.m_memory);
+}
+
+#endif
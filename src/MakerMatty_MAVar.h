@@ -0,0 +1,399 @@
+/**
+ * Author	: @makermatty (maker.matejsuchanek.cz)
+ * Date		: 15-10-2026
+ *
+ * Moving variance
+ * Mean, variance and standard deviation of the last n values, updated in O(1) from the
+ * same ring as MA<T> instead of walking the window again.
+ * 8 and 16 bit integers keep the exact sum and sum of squares in 64 bit integers, the
+ * variance n * sum(x^2) - sum(x)^2 is exact before the final division.
+ * Other types keep the mean and the sum of squared deviations (Welford) and slide them as
+ * one value replaces another. Rounding errors of the sliding update would add up over
+ * time, so every n updates the mean and the deviations are recomputed from the window
+ * (one pass over the ring, amortized O(1) per update).
+ * The variance is the population variance of the window, while the ring fills it is over
+ * the values seen so far, like the MA averages.
+ */
+
+#ifndef _MM_MAVAR_H
+#define _MM_MAVAR_H
+
+#include "MakerMatty_MA.h"
+
+#include <math.h>
+#include <type_traits>
+
+/**
+ * Type of the mean, variance and standard deviation of values of type T
+ * float for float and integer values, double for double.
+ */
+template <class T>
+struct MAVarResult {
+    typedef typename std::conditional<std::is_floating_point<T>::value && (sizeof(T) > sizeof(float)), T, float>::type type;
+};
+
+/**
+ * Running statistics of a window, exact sums for 8 and 16 bit integers
+ */
+template <class T, class K, bool = std::is_integral<T>::value && sizeof(T) <= 2>
+class MAVarSums {
+
+public:
+    void clear()
+    {
+        m_sum = 0;
+        m_squares = 0;
+    }
+
+    void fill(const T val, const uint16_t n)
+    {
+        m_sum = (int64_t)val * n;
+        m_squares = (uint64_t)((int64_t)val * val) * n;
+    }
+
+    void add(const T val, const uint16_t)
+    {
+        m_sum += val;
+        m_squares += (uint64_t)((int64_t)val * val);
+    }
+
+    void replace(const T old, const T val, const uint16_t)
+    {
+        m_sum += (int64_t)val - old;
+        m_squares += (uint64_t)((int64_t)val * val) - (uint64_t)((int64_t)old * old);
+    }
+
+    void anchor(const T*, const uint16_t)
+    {
+    }
+
+    // truncated like MA
+    T value(const uint16_t count) const
+    {
+        return count ? (T)(m_sum / count) : T(0);
+    }
+
+    K mean(const uint16_t count) const
+    {
+        return count ? (K)m_sum / count : K(0);
+    }
+
+    K variance(const uint16_t count) const
+    {
+        if (!count) {
+            return K(0);
+        }
+        // fits: n * sum(x^2) <= 65535 * 65535 * 65535^2 < 2^64
+        const uint64_t sum = (uint64_t)(m_sum < 0 ? -m_sum : m_sum);
+        return (K)((uint64_t)count * m_squares - sum * sum) / ((K)count * count);
+    }
+
+private:
+    int64_t m_sum; // sum of the window
+    uint64_t m_squares; // sum of the squares of the window
+};
+
+/**
+ * Running statistics of a window, sliding Welford for other types
+ */
+template <class T, class K>
+class MAVarSums<T, K, false> {
+    typedef typename std::conditional<(sizeof(K) > sizeof(double)), K, double>::type S;
+    typedef typename MAAccumulator<T>::type A;
+
+public:
+    void clear()
+    {
+        m_sum = 0;
+        m_mean = 0;
+        m_m2 = 0;
+    }
+
+    void fill(const T val, const uint16_t n)
+    {
+        m_sum = (A)val * n;
+        m_mean = (S)val;
+        m_m2 = 0;
+    }
+
+    // count includes the new value
+    void add(const T val, const uint16_t count)
+    {
+        m_sum += (A)val;
+        const S delta = (S)val - m_mean;
+        m_mean += delta / count;
+        m_m2 += delta * ((S)val - m_mean);
+    }
+
+    void replace(const T old, const T val, const uint16_t n)
+    {
+        m_sum += (A)val - (A)old;
+        const S delta = (S)val - (S)old;
+        const S mean = m_mean + delta / n;
+        m_m2 += delta * (((S)val - mean) + ((S)old - m_mean));
+        m_mean = mean;
+    }
+
+    // recomputes both from the window, drops the rounding errors of the sliding updates
+    void anchor(const T* data, const uint16_t n)
+    {
+        S sum = 0;
+        for (uint16_t i = 0; i < n; i++) {
+            sum += (S)data[i];
+        }
+        m_mean = sum / n;
+
+        S m2 = 0;
+        for (uint16_t i = 0; i < n; i++) {
+            const S delta = (S)data[i] - m_mean;
+            m2 += delta * delta;
+        }
+        m_m2 = m2;
+    }
+
+    // integers truncated from the exact sum like MA
+    T value(const uint16_t count) const
+    {
+        return std::is_integral<T>::value ? (count ? (T)(m_sum / (A)count) : T(0)) : (T)m_mean;
+    }
+
+    K mean(const uint16_t) const
+    {
+        return (K)m_mean;
+    }
+
+    K variance(const uint16_t count) const
+    {
+        return count && m_m2 > 0 ? (K)(m_m2 / count) : K(0);
+    }
+
+private:
+    A m_sum; // sum of the window, for value()
+    S m_mean; // mean of the window
+    S m_m2; // sum of the squared deviations from m_mean
+};
+
+template <class T>
+class MAVar {
+
+public:
+    typedef typename MAVarResult<T>::type K;
+
+    MAVar();
+    MAVar(const uint16_t n, T init = 0);
+    MAVar(const MAVar<T>& other); // copy contructor
+    MAVar(MAVar<T>&& other) noexcept; // move contructor
+    ~MAVar();
+
+    T update(const T val);
+    T update(const T* in, size_t count, T* out = nullptr);
+
+    T getValue() const;
+    void setValue(const T val);
+
+    K getMean() const;
+    K getVariance() const;
+    K getStdDev() const;
+
+    uint16_t getCount() const;
+
+    MAVar<T>& operator=(const MAVar<T>& other);
+    MAVar<T>& operator=(MAVar<T>&& other) noexcept;
+
+    void swap(MAVar<T>& other) noexcept;
+
+private:
+    uint16_t m_n; // number of elements in our array
+    T* m_data; // ring of the last m_n values
+    uint16_t m_index; // current m_index
+    uint16_t m_count; // number of values in the window
+    MAVarSums<T, K> m_sums;
+};
+
+template <class T>
+MAVar<T>::MAVar()
+    : m_n(1)
+    , m_data(new T[1])
+{
+    this->setValue(0);
+}
+
+/**
+ * @name MAVar Constructor
+ * @param n			number of values in the window
+ * @param init		fills the window when not 0 (as MA)
+ */
+template <class T>
+MAVar<T>::MAVar(const uint16_t n, T init)
+    : m_n(n == 0 ? 1 : n)
+    , m_data(new T[m_n])
+{
+    if (n == 0) {
+        log_e("n must not be 0");
+    }
+    this->setValue(init);
+}
+
+// copy contructor
+template <class T>
+MAVar<T>::MAVar(const MAVar<T>& other)
+    : m_n(other.m_n)
+    , m_data(other.m_data ? new T[other.m_n] : nullptr)
+    , m_index(other.m_index)
+    , m_count(other.m_count)
+    , m_sums(other.m_sums)
+{
+    if (m_data) {
+        memcpy(m_data, other.m_data, m_n * sizeof(T));
+    }
+}
+
+template <class T>
+MAVar<T>::MAVar(MAVar<T>&& other) noexcept
+    : m_n(std::exchange(other.m_n, 0))
+    , m_data(std::exchange(other.m_data, nullptr))
+    , m_index(std::exchange(other.m_index, 0))
+    , m_count(std::exchange(other.m_count, 0))
+    , m_sums(other.m_sums)
+{
+}
+
+template <class T>
+MAVar<T>::~MAVar()
+{
+    delete[] m_data;
+}
+
+/**
+ * @name update
+ * @param val	value to be added to the window
+ * @returns T	the moving average, as MA
+ */
+template <class T>
+T MAVar<T>::update(const T val)
+{
+    if (m_count < m_n) {
+        m_data[m_index] = val;
+        m_sums.add(val, ++m_count);
+    } else {
+        m_sums.replace(m_data[m_index], val, m_n);
+        m_data[m_index] = val;
+    }
+
+    if (++m_index >= m_n) {
+        m_index = 0;
+        m_sums.anchor(m_data, m_n);
+    }
+
+    return this->getValue();
+}
+
+/**
+ * @name update
+ * @param in	block of count values
+ * @param out	optional, receives the moving average after every value
+ * @returns T	the moving average after the last value
+ */
+template <class T>
+T MAVar<T>::update(const T* in, size_t count, T* out)
+{
+    for (size_t i = 0; i < count; i++) {
+        const T value = this->update(in[i]);
+        if (out) {
+            out[i] = value;
+        }
+    }
+    return this->getValue();
+}
+
+template <class T>
+T MAVar<T>::getValue() const
+{
+    return m_sums.value(m_count);
+}
+
+/**
+ * @name setValue
+ * Fills the window with val, 0 empties it.
+ */
+template <class T>
+void MAVar<T>::setValue(const T val)
+{
+    m_index = 0;
+    if (val != 0) {
+        for (uint16_t i = 0; i < m_n; i++) {
+            m_data[i] = val;
+        }
+        m_count = m_n;
+        m_sums.fill(val, m_n);
+    } else {
+        m_count = 0;
+        m_sums.clear();
+    }
+}
+
+template <class T>
+typename MAVar<T>::K MAVar<T>::getMean() const
+{
+    return m_sums.mean(m_count);
+}
+
+template <class T>
+typename MAVar<T>::K MAVar<T>::getVariance() const
+{
+    return m_sums.variance(m_count);
+}
+
+template <class T>
+typename MAVar<T>::K MAVar<T>::getStdDev() const
+{
+    return (K)sqrt(this->getVariance());
+}
+
+template <class T>
+uint16_t MAVar<T>::getCount() const
+{
+    return m_count;
+}
+
+// copy assignment
+template <class T>
+MAVar<T>& MAVar<T>::operator=(const MAVar<T>& other)
+{
+    if (this != &other) {
+        MAVar<T>(other).swap(*this); // Copy-constructor and non-throwing swap
+    }
+
+    return *this;
+}
+
+// move assignment
+template <class T>
+MAVar<T>& MAVar<T>::operator=(MAVar<T>&& other) noexcept
+{
+    // Guard self assignment
+    if (this == &other)
+        return *this;
+
+    delete[] m_data;
+
+    m_n = std::exchange(other.m_n, 0);
+    m_data = std::exchange(other.m_data, nullptr);
+    m_index = std::exchange(other.m_index, 0);
+    m_count = std::exchange(other.m_count, 0);
+    m_sums = other.m_sums;
+
+    return *this;
+}
+
+template <class T>
+void MAVar<T>::swap(MAVar<T>& other) noexcept
+{
+    std::swap(this->m_n, other.m_n);
+    std::swap(this->m_data, other.m_data);
+    std::swap(this->m_index, other.m_index);
+    std::swap(this->m_count, other.m_count);
+    std::swap(this->m_sums, other.m_sums);
+}
+
+#endif
@@ -0,0 +1,783 @@
+/**
+ * Author	: @makermatty (maker.matejsuchanek.cz)
+ * Date		: 15-10-2026
+ *
+ * Moving median
+ * Median of the last n values for spike suppression, e.g. in front of an MA. The window
+ * is kept as two heaps around the median in the same ring as MA<T> (Ekstrom's mediator):
+ * a max heap of the lower half and a min heap of the upper half, with every ring slot
+ * knowing its heap slot, so the new value replaces the oldest one in place and only
+ * sifts through one heap, O(log n) per update. While the ring fills the median is over
+ * the values seen so far. For an even count it is the mean of the two middle values
+ * (truncated for integers).
+ *
+ * MovingMedian<T, N> with N = 3, 5, 7 or 9 instead sorts the window with a branch-free
+ * min/max network (Devillard's opt_med) every update, which is faster than any bookkeeping
+ * at these sizes.
+ *
+ * 8 bit integers (ADC samples) count the window in a two level histogram instead
+ * (Huang / Perreault): the median bin moves by at most one rank per update, so the cost
+ * does not depend on n. The histogram takes 16 + 256 counters (544 B) regardless of n,
+ * inside the object for a fixed N, allocated with the ring for a runtime n. 16 bit types
+ * need 256 + 65536 counters (128.5 KB), which does not fit a small target and costs more
+ * than the sifts for short windows, so they keep the heap: pass MM_MEDIAN_HISTOGRAM as the
+ * third parameter to opt in, e.g. MovingMedian<int16_t, 0, MM_MEDIAN_HISTOGRAM> m(1001).
+ * A fixed 16 bit window then is a 128.5 KB object, give it static storage, not the stack.
+ * Pass MM_MEDIAN_HEAP to keep the heap for 8 bit types.
+ */
+
+#ifndef _MM_MEDIAN_H
+#define _MM_MEDIAN_H
+
+#include "MakerMatty_MA.h"
+#include "MakerMatty_Ring.h"
+
+#include <algorithm>
+#include <type_traits>
+
+enum MovingMedianPath {
+    MM_MEDIAN_HEAP,
+    MM_MEDIAN_NETWORK,
+    MM_MEDIAN_HISTOGRAM,
+};
+
+/**
+ * Implementation picked for MovingMedian<T, N>
+ */
+template <class T, uint16_t N>
+struct MovingMedianMethod {
+    static const bool NARROW = std::is_integral<T>::value && !std::is_same<T, bool>::value
+        && sizeof(T) == 1;
+
+    static const MovingMedianPath value = (N == 3 || N == 5 || N == 7 || N == 9)
+        ? MM_MEDIAN_NETWORK
+        : (NARROW ? MM_MEDIAN_HISTOGRAM : MM_MEDIAN_HEAP);
+};
+
+/**
+ * Mean of the two middle values of an even window, in the MA accumulator so it does not overflow
+ */
+template <class T>
+inline T MovingMedianMean(const T a, const T b)
+{
+    typedef typename MAAccumulator<T>::type A;
+    return (T)(((A)a + (A)b) / 2);
+}
+
+template <class T, uint16_t N = 0, MovingMedianPath P = MovingMedianMethod<T, N>::value>
+class MovingMedian;
+
+/**
+ * Moving median, double heap
+ * MovingMedian<T> m(n, init) with a runtime window, MovingMedian<T, N> m(init) with a fixed
+ * one. A non-zero init fills the window, like MA.
+ */
+template <class T, uint16_t N>
+class MovingMedian<T, N, MM_MEDIAN_HEAP> {
+
+public:
+    template <uint16_t M = N, typename std::enable_if<M == 0, int>::type = 0>
+    MovingMedian(const uint16_t n, T init = 0)
+        : m_storage(n == 0 ? 1 : n)
+    {
+        if (n == 0) {
+            log_e("n must not be 0");
+        }
+        this->setValue(init);
+    }
+
+    template <uint16_t M = N, typename std::enable_if<M != 0, int>::type = 0>
+    MovingMedian(T init = 0)
+        : m_storage(N)
+    {
+        this->setValue(init);
+    }
+
+    T update(const T val)
+    {
+        this->push(val);
+        return this->median();
+    }
+
+    /**
+     * @name update
+     * @param in	block of count values
+     * @param out	optional, receives the median after every value
+     * @returns T	the median after the last value
+     */
+    T update(const T* in, size_t count, T* out = nullptr)
+    {
+        for (size_t i = 0; i < count; i++) {
+            this->push(in[i]);
+            if (out) {
+                out[i] = this->median();
+            }
+        }
+        return this->median();
+    }
+
+    T getValue() const
+    {
+        return this->median();
+    }
+
+    /**
+     * @name setValue
+     * Empties the window, a non-zero value then fills it.
+     */
+    void setValue(const T val)
+    {
+        const uint16_t n = m_storage.size();
+        m_index = 0;
+        m_count = 0;
+
+        // ring slot i starts in heap slot 0, -1, 1, -2, 2, ... so the heaps grow alternately
+        for (uint16_t i = 0; i < n; i++) {
+            const int32_t p = ((int32_t)i + 1) / 2 * ((i & 1) ? -1 : 1);
+            pos()[i] = (uint16_t)(int16_t)p;
+            heap()[p] = i;
+        }
+
+        if (val != 0) {
+            for (uint16_t i = 0; i < n; i++) {
+                this->push(val);
+            }
+        }
+    }
+
+    uint16_t getSize() const
+    {
+        return m_storage.size();
+    }
+
+    uint16_t getCount() const
+    {
+        return m_count;
+    }
+
+private:
+    // heap slot 0 is the median, 1.. the min heap above it, -1.. the max heap below it
+    uint16_t* heap()
+    {
+        return m_storage.index(0) + m_storage.size() / 2;
+    }
+
+    const uint16_t* heap() const
+    {
+        return m_storage.index(0) + m_storage.size() / 2;
+    }
+
+    // heap slot of every ring slot, int16_t stored as uint16_t
+    uint16_t* pos()
+    {
+        return m_storage.index(1);
+    }
+
+    int32_t minCount() const
+    {
+        return ((int32_t)m_count - 1) / 2;
+    }
+
+    int32_t maxCount() const
+    {
+        return (int32_t)m_count / 2;
+    }
+
+    // value at heap slot i < value at heap slot j
+    bool less(const int32_t i, const int32_t j) const
+    {
+        return m_storage.data()[heap()[i]] < m_storage.data()[heap()[j]];
+    }
+
+    bool exchange(const int32_t i, const int32_t j)
+    {
+        uint16_t* h = heap();
+        const uint16_t t = h[i];
+        h[i] = h[j];
+        h[j] = t;
+        pos()[h[i]] = (uint16_t)(int16_t)i;
+        pos()[h[j]] = (uint16_t)(int16_t)j;
+        return true;
+    }
+
+    bool exchangeIfLess(const int32_t i, const int32_t j)
+    {
+        return this->less(i, j) && this->exchange(i, j);
+    }
+
+    // i is the first child to look at, slot 1 is the only child of the median
+    void minSortDown(int32_t i)
+    {
+        for (; i <= minCount(); i *= 2) {
+            if (i > 1 && i < minCount() && this->less(i + 1, i)) {
+                ++i;
+            }
+            if (!this->exchangeIfLess(i, i / 2)) {
+                break;
+            }
+        }
+    }
+
+    void maxSortDown(int32_t i)
+    {
+        for (; i >= -maxCount(); i *= 2) {
+            if (i < -1 && i > -maxCount() && this->less(i, i - 1)) {
+                --i;
+            }
+            if (!this->exchangeIfLess(i / 2, i)) {
+                break;
+            }
+        }
+    }
+
+    // returns true when the value reached the median slot
+    bool minSortUp(int32_t i)
+    {
+        while (i > 0 && this->exchangeIfLess(i, i / 2)) {
+            i /= 2;
+        }
+        return i == 0;
+    }
+
+    bool maxSortUp(int32_t i)
+    {
+        while (i < 0 && this->exchangeIfLess(i / 2, i)) {
+            i /= 2;
+        }
+        return i == 0;
+    }
+
+    /**
+     * @name push
+     * Replaces the oldest value in its heap slot and restores the heaps from there.
+     */
+    void push(const T val)
+    {
+        const uint16_t n = m_storage.size();
+        const bool grow = m_count < n;
+        const int32_t p = (int16_t)pos()[m_index];
+        const T old = grow ? val : m_storage.data()[m_index];
+
+        m_storage.data()[m_index] = val;
+        m_index = m_index + 1 == n ? 0 : m_index + 1;
+        m_count += grow;
+
+        if (p > 0) {
+            if (!grow && old < val) {
+                this->minSortDown(p * 2);
+            } else if (this->minSortUp(p)) {
+                this->maxSortDown(-1);
+            }
+        } else if (p < 0) {
+            if (!grow && val < old) {
+                this->maxSortDown(p * 2);
+            } else if (this->maxSortUp(p)) {
+                this->minSortDown(1);
+            }
+        } else {
+            if (maxCount()) {
+                this->maxSortDown(-1);
+            }
+            if (minCount()) {
+                this->minSortDown(1);
+            }
+        }
+    }
+
+    T median() const
+    {
+        if (!m_count) {
+            return 0;
+        }
+        const T* data = m_storage.data();
+        const T mid = data[heap()[0]];
+        return (m_count & 1) ? mid : MovingMedianMean(data[heap()[-1]], mid);
+    }
+
+    MMRingStorage<T, N, 2> m_storage; // values, heap, heap slot of every value
+    uint16_t m_index; // slot the next value goes to
+    uint16_t m_count; // number of values in the window
+};
+
+/**
+ * Moving median, sorting network for N = 3, 5, 7, 9
+ */
+template <class T, uint16_t N>
+class MovingMedian<T, N, MM_MEDIAN_NETWORK> {
+
+public:
+    MovingMedian(T init = 0)
+    {
+        this->setValue(init);
+    }
+
+    T update(const T val)
+    {
+        m_data[m_index] = val;
+        m_index = m_index + 1 == N ? 0 : m_index + 1;
+        m_count += m_count < N;
+        return m_value = m_count == N ? network(m_data) : warmup();
+    }
+
+    /**
+     * @name update
+     * @param in	block of count values
+     * @param out	optional, receives the median after every value
+     * @returns T	the median after the last value
+     */
+    T update(const T* in, size_t count, T* out = nullptr)
+    {
+        for (size_t i = 0; i < count; i++) {
+            const T value = this->update(in[i]);
+            if (out) {
+                out[i] = value;
+            }
+        }
+        return m_value;
+    }
+
+    T getValue() const
+    {
+        return m_value;
+    }
+
+    void setValue(const T val)
+    {
+        for (uint16_t i = 0; i < N; i++) {
+            m_data[i] = val;
+        }
+        m_index = 0;
+        m_count = val != 0 ? N : 0;
+        m_value = val;
+    }
+
+    uint16_t getSize() const
+    {
+        return N;
+    }
+
+    uint16_t getCount() const
+    {
+        return m_count;
+    }
+
+private:
+    // compare-exchange as min and max, no branch for arithmetic types
+    static void sort(T& a, T& b)
+    {
+        const T lo = std::min(a, b);
+        const T hi = std::max(a, b);
+        a = lo;
+        b = hi;
+    }
+
+    typedef std::integral_constant<uint16_t, N> Size;
+
+    static T network(const T* data)
+    {
+        T p[N];
+        memcpy(p, data, sizeof(p));
+        return network(p, Size());
+    }
+
+    static T network(T* p, std::integral_constant<uint16_t, 3>)
+    {
+        sort(p[0], p[1]); sort(p[1], p[2]); sort(p[0], p[1]);
+        return p[1];
+    }
+
+    static T network(T* p, std::integral_constant<uint16_t, 5>)
+    {
+        sort(p[0], p[1]); sort(p[3], p[4]); sort(p[0], p[3]);
+        sort(p[1], p[4]); sort(p[1], p[2]); sort(p[2], p[3]);
+        sort(p[1], p[2]);
+        return p[2];
+    }
+
+    static T network(T* p, std::integral_constant<uint16_t, 7>)
+    {
+        sort(p[0], p[5]); sort(p[0], p[3]); sort(p[1], p[6]);
+        sort(p[2], p[4]); sort(p[0], p[1]); sort(p[3], p[5]);
+        sort(p[2], p[6]); sort(p[2], p[3]); sort(p[3], p[6]);
+        sort(p[4], p[5]); sort(p[1], p[4]); sort(p[1], p[3]);
+        sort(p[3], p[4]);
+        return p[3];
+    }
+
+    static T network(T* p, std::integral_constant<uint16_t, 9>)
+    {
+        sort(p[1], p[2]); sort(p[4], p[5]); sort(p[7], p[8]);
+        sort(p[0], p[1]); sort(p[3], p[4]); sort(p[6], p[7]);
+        sort(p[1], p[2]); sort(p[4], p[5]); sort(p[7], p[8]);
+        sort(p[0], p[3]); sort(p[5], p[8]); sort(p[4], p[7]);
+        sort(p[3], p[6]); sort(p[1], p[4]); sort(p[2], p[5]);
+        sort(p[4], p[7]); sort(p[4], p[2]); sort(p[6], p[4]);
+        sort(p[4], p[2]);
+        return p[4];
+    }
+
+    // fewer than N values so far, insertion sort of what is there
+    T warmup() const
+    {
+        T p[N];
+        for (uint16_t i = 0; i < m_count; i++) {
+            uint16_t j = i;
+            for (; j > 0 && m_data[i] < p[j - 1]; j--) {
+                p[j] = p[j - 1];
+            }
+            p[j] = m_data[i];
+        }
+        return (m_count & 1) ? p[m_count / 2] : MovingMedianMean(p[m_count / 2 - 1], p[m_count / 2]);
+    }
+
+    T m_data[N];
+    uint8_t m_index; // slot the next value goes to
+    uint8_t m_count; // number of values in the window
+    T m_value = 0;
+};
+
+/**
+ * Counters and ring of the histogram median
+ * A fixed N keeps them inside the object, a runtime n allocates them in one block.
+ */
+template <class T, uint16_t N, uint32_t COUNTERS>
+class MovingMedianBins {
+
+public:
+    MovingMedianBins(const uint16_t)
+    {
+    }
+
+    uint16_t size() const
+    {
+        return N;
+    }
+
+    uint16_t* counters()
+    {
+        return m_counters;
+    }
+
+    const uint16_t* counters() const
+    {
+        return m_counters;
+    }
+
+    T* ring()
+    {
+        return m_ring;
+    }
+
+private:
+    uint16_t m_counters[COUNTERS];
+    T m_ring[N];
+};
+
+template <class T, uint32_t COUNTERS>
+class MovingMedianBins<T, 0, COUNTERS> {
+
+public:
+    MovingMedianBins(const uint16_t n)
+        : m_n(n)
+        , m_memory(new uint16_t[words()])
+    {
+    }
+
+    MovingMedianBins(const MovingMedianBins& other) // copy contructor
+        : m_n(other.m_n)
+        , m_memory(other.m_memory ? new uint16_t[other.words()] : nullptr)
+    {
+        if (m_memory) {
+            memcpy(m_memory, other.m_memory, words() * sizeof(uint16_t));
+        }
+    }
+
+    MovingMedianBins(MovingMedianBins&& other) noexcept // move contructor
+        : m_n(std::exchange(other.m_n, 0))
+        , m_memory(std::exchange(other.m_memory, nullptr))
+    {
+    }
+
+    ~MovingMedianBins()
+    {
+        delete[] m_memory;
+    }
+
+    MovingMedianBins& operator=(const MovingMedianBins& other)
+    {
+        if (this != &other) {
+            MovingMedianBins(other).swap(*this); // Copy-constructor and non-throwing swap
+        }
+        return *this;
+    }
+
+    MovingMedianBins& operator=(MovingMedianBins&& other) noexcept
+    {
+        // Guard self assignment
+        if (this == &other)
+            return *this;
+
+        delete[] m_memory;
+        m_n = std::exchange(other.m_n, 0);
+        m_memory = std::exchange(other.m_memory, nullptr);
+        return *this;
+    }
+
+    void swap(MovingMedianBins& other) noexcept
+    {
+        std::swap(this->m_n, other.m_n);
+        std::swap(this->m_memory, other.m_memory);
+    }
+
+    uint16_t size() const
+    {
+        return m_n;
+    }
+
+    uint16_t* counters()
+    {
+        return m_memory;
+    }
+
+    const uint16_t* counters() const
+    {
+        return m_memory;
+    }
+
+    T* ring()
+    {
+        return (T*)(m_memory + COUNTERS);
+    }
+
+private:
+    // counters first, the ring behind them
+    size_t words() const
+    {
+        return COUNTERS + ((size_t)m_n * sizeof(T) + 1) / 2;
+    }
+
+    uint16_t m_n; // number of elements in our array
+    uint16_t* m_memory; // counters, ring
+};
+
+/**
+ * Moving median, histogram of 8 and 16 bit integers
+ * Values map to unsigned keys (signed types with the sign bit flipped, so the order is
+ * kept) counted in fine bins and in coarse groups of them. The median is tracked as its
+ * key and the number of values below it, an update only moves it to the neighbouring
+ * non-empty bin, found through the coarse groups.
+ */
+template <class T, uint16_t N>
+class MovingMedian<T, N, MM_MEDIAN_HISTOGRAM> {
+    static_assert(std::is_integral<T>::value && sizeof(T) <= 2, "the histogram counts 8 and 16 bit integers");
+
+public:
+    template <uint16_t M = N, typename std::enable_if<M == 0, int>::type = 0>
+    MovingMedian(const uint16_t n, T init = 0)
+        : m_storage(n == 0 ? 1 : n)
+    {
+        if (n == 0) {
+            log_e("n must not be 0");
+        }
+        this->setValue(init);
+    }
+
+    template <uint16_t M = N, typename std::enable_if<M != 0, int>::type = 0>
+    MovingMedian(T init = 0)
+        : m_storage(N)
+    {
+        this->setValue(init);
+    }
+
+    T update(const T val)
+    {
+        const uint16_t n = m_storage.size();
+        uint16_t* coarse = this->coarse();
+        uint16_t* fine = this->fine();
+
+        if (m_count == n) {
+            const uint32_t old = key(ring()[m_index]);
+            --fine[old];
+            --coarse[old >> SHIFT];
+            m_below -= old < m_key;
+        } else {
+            ++m_count;
+        }
+
+        const uint32_t k = key(val);
+        ++fine[k];
+        ++coarse[k >> SHIFT];
+        m_below += k < m_key;
+
+        ring()[m_index] = val;
+        m_index = m_index + 1 == n ? 0 : m_index + 1;
+
+        // move to the bin of rank (count - 1) / 2, the lower median
+        const uint16_t rank = (m_count - 1) / 2;
+        while (m_below > rank) {
+            m_key = this->prev(m_key);
+            m_below -= fine[m_key];
+        }
+        while (m_below + fine[m_key] <= rank) {
+            m_below += fine[m_key];
+            m_key = this->next(m_key);
+        }
+
+        if (m_count & 1) {
+            return m_value = value(m_key);
+        }
+        const uint32_t upper = m_below + fine[m_key] > rank + 1 ? m_key : this->next(m_key);
+        return m_value = MovingMedianMean(value(m_key), value(upper));
+    }
+
+    /**
+     * @name update
+     * @param in	block of count values
+     * @param out	optional, receives the median after every value
+     * @returns T	the median after the last value
+     */
+    T update(const T* in, size_t count, T* out = nullptr)
+    {
+        for (size_t i = 0; i < count; i++) {
+            const T value = this->update(in[i]);
+            if (out) {
+                out[i] = value;
+            }
+        }
+        return m_value;
+    }
+
+    T getValue() const
+    {
+        return m_value;
+    }
+
+    /**
+     * @name setValue
+     * Empties the window, a non-zero value then fills it.
+     */
+    void setValue(const T val)
+    {
+        const uint16_t n = m_storage.size();
+        memset(m_storage.counters(), 0, (GROUPS + BINS) * sizeof(uint16_t));
+        m_index = 0;
+        m_count = 0;
+        m_key = 0;
+        m_below = 0;
+        m_value = 0;
+
+        if (val != 0) {
+            for (uint16_t i = 0; i < n; i++) {
+                ring()[i] = val;
+            }
+            m_key = key(val);
+            fine()[m_key] = n;
+            coarse()[m_key >> SHIFT] = n;
+            m_count = n;
+            m_value = val;
+        }
+    }
+
+    uint16_t getSize() const
+    {
+        return m_storage.size();
+    }
+
+    uint16_t getCount() const
+    {
+        return m_count;
+    }
+
+private:
+    typedef typename std::make_unsigned<T>::type U;
+
+    static const uint32_t BINS = (uint32_t)1 << (8 * sizeof(T));
+    static const uint8_t SHIFT = sizeof(T) == 1 ? 4 : 8; // fine bins per coarse group = 2^SHIFT
+    static const uint32_t MASK = ((uint32_t)1 << SHIFT) - 1;
+    static const uint32_t GROUPS = BINS >> SHIFT;
+    static const U SIGN = std::is_signed<T>::value ? (U)((U)1 << (8 * sizeof(T) - 1)) : 0;
+
+    static uint32_t key(const T val)
+    {
+        return (U)((U)val ^ SIGN);
+    }
+
+    static T value(const uint32_t key)
+    {
+        return (T)(U)((U)key ^ SIGN);
+    }
+
+    uint16_t* coarse()
+    {
+        return m_storage.counters();
+    }
+
+    const uint16_t* coarse() const
+    {
+        return m_storage.counters();
+    }
+
+    uint16_t* fine()
+    {
+        return m_storage.counters() + GROUPS;
+    }
+
+    const uint16_t* fine() const
+    {
+        return m_storage.counters() + GROUPS;
+    }
+
+    T* ring()
+    {
+        return m_storage.ring();
+    }
+
+    // nearest non-empty bin above k, there must be one
+    uint32_t next(uint32_t k) const
+    {
+        const uint16_t* fine = this->fine();
+        const uint32_t end = (k | MASK) + 1;
+        while (++k < end) {
+            if (fine[k]) {
+                return k;
+            }
+        }
+
+        uint32_t group = end >> SHIFT;
+        while (!coarse()[group]) {
+            ++group;
+        }
+        for (k = group << SHIFT; !fine[k]; k++) {
+        }
+        return k;
+    }
+
+    // nearest non-empty bin below k, there must be one
+    uint32_t prev(uint32_t k) const
+    {
+        const uint16_t* fine = this->fine();
+        const uint32_t start = k & ~MASK;
+        while (k > start) {
+            if (fine[--k]) {
+                return k;
+            }
+        }
+
+        uint32_t group = start >> SHIFT;
+        do {
+            --group;
+        } while (!coarse()[group]);
+        for (k = (group << SHIFT) | MASK; !fine[k]; k--) {
+        }
+        return k;
+    }
+
+    MovingMedianBins<T, N, GROUPS + BINS> m_storage; // coarse groups, fine bins, ring
+    uint16_t m_index; // slot the next value goes to
+    uint16_t m_count; // number of values in the window
+    uint32_t m_key; // bin of the lower median
+    uint16_t m_below; // number of values in bins below m_key
+    T m_value;
+};
+
+#endif
@@ -0,0 +1,301 @@
+/**
+ * Author	: @makermatty (maker.matejsuchanek.cz)
+ * Date		: 15-10-2026
+ *
+ * Moving minimum, maximum and range
+ * Same ring buffer as MA<T> plus a monotonic wedge (Lemire) per extreme: a deque of ring
+ * positions whose values only increase (min) or decrease (max) from front to back. Every
+ * sample is pushed once and popped at most once, so an update is amortized O(1) and the
+ * extreme is always the front. While the ring fills the extremes are over the values seen
+ * so far, like the MA averages.
+ *
+ * MovingMin<T, N>, MovingMax<T, N> and MovingRange<T, N> with N > 0 keep everything inline,
+ * with N == 0 the window is given at runtime and allocated once.
+ */
+
+#ifndef _MM_MINMAX_H
+#define _MM_MINMAX_H
+
+#include "MakerMatty_Ring.h"
+
+#include <type_traits>
+
+/**
+ * Moving extremes core, MovingMin, MovingMax and MovingRange pick the wedges they need
+ */
+template <class T, uint16_t N, bool MIN, bool MAX>
+class MovingExtrema {
+
+public:
+    uint16_t getSize() const
+    {
+        return m_storage.size();
+    }
+
+    uint16_t getCount() const
+    {
+        return m_count;
+    }
+
+protected:
+    MovingExtrema(const uint16_t n, const T init)
+        : m_storage(n == 0 ? 1 : n)
+    {
+        if (n == 0) {
+            log_e("n must not be 0");
+        }
+
+        this->clear();
+        if (init != 0) {
+            for (uint16_t i = 0; i < m_storage.size(); i++) {
+                this->push(init);
+            }
+        }
+    }
+
+    void clear()
+    {
+        m_index = 0;
+        m_count = 0;
+        m_minHead = 0;
+        m_minSize = 0;
+        m_maxHead = 0;
+        m_maxSize = 0;
+    }
+
+    /**
+     * @name push
+     * Expires the value about to be overwritten from the wedge fronts, writes the new
+     * value into the ring and drops the values it dominates from the wedge backs.
+     */
+    void push(const T val)
+    {
+        const uint16_t n = m_storage.size();
+        T* data = m_storage.data();
+
+        if (m_count == n) {
+            if (MIN && m_minSize && m_storage.index(0)[m_minHead] == m_index) {
+                m_minHead = m_minHead + 1 == n ? 0 : m_minHead + 1;
+                --m_minSize;
+            }
+            if (MAX && m_maxSize && m_storage.index(MIN ? 1 : 0)[m_maxHead] == m_index) {
+                m_maxHead = m_maxHead + 1 == n ? 0 : m_maxHead + 1;
+                --m_maxSize;
+            }
+        } else {
+            ++m_count;
+        }
+
+        data[m_index] = val;
+
+        if (MIN) {
+            uint16_t* q = m_storage.index(0);
+            while (m_minSize && !(data[q[wrap(m_minHead + m_minSize - 1)]] < val)) {
+                --m_minSize;
+            }
+            q[wrap(m_minHead + m_minSize)] = m_index;
+            ++m_minSize;
+        }
+
+        if (MAX) {
+            uint16_t* q = m_storage.index(MIN ? 1 : 0);
+            while (m_maxSize && !(val < data[q[wrap(m_maxHead + m_maxSize - 1)]])) {
+                --m_maxSize;
+            }
+            q[wrap(m_maxHead + m_maxSize)] = m_index;
+            ++m_maxSize;
+        }
+
+        m_index = m_index + 1 == n ? 0 : m_index + 1;
+    }
+
+    T min() const
+    {
+        return m_minSize ? m_storage.data()[m_storage.index(0)[m_minHead]] : T(0);
+    }
+
+    T max() const
+    {
+        return m_maxSize ? m_storage.data()[m_storage.index(MIN ? 1 : 0)[m_maxHead]] : T(0);
+    }
+
+private:
+    uint16_t wrap(const uint32_t i) const
+    {
+        return (uint16_t)(i >= m_storage.size() ? i - m_storage.size() : i);
+    }
+
+    MMRingStorage<T, N, (MIN ? 1 : 0) + (MAX ? 1 : 0)> m_storage; // values, min wedge, max wedge
+    uint16_t m_index; // slot the next value goes to
+    uint16_t m_count; // number of values in the window
+    uint16_t m_minHead; // front of the min wedge
+    uint16_t m_minSize;
+    uint16_t m_maxHead; // front of the max wedge
+    uint16_t m_maxSize;
+};
+
+/**
+ * Moving minimum over the last n values
+ * MovingMin<T> m(n, init) with a runtime window, MovingMin<T, N> m(init) with a fixed one.
+ * A non-zero init fills the window, like MA.
+ */
+template <class T, uint16_t N = 0>
+class MovingMin : public MovingExtrema<T, N, true, false> {
+    typedef MovingExtrema<T, N, true, false> Base;
+
+public:
+    template <uint16_t M = N, typename std::enable_if<M == 0, int>::type = 0>
+    MovingMin(const uint16_t n, T init = 0)
+        : Base(n, init)
+    {
+    }
+
+    template <uint16_t M = N, typename std::enable_if<M != 0, int>::type = 0>
+    MovingMin(T init = 0)
+        : Base(N, init)
+    {
+    }
+
+    T update(const T val)
+    {
+        this->push(val);
+        return this->min();
+    }
+
+    /**
+     * @name update
+     * @param in	block of count values
+     * @param out	optional, receives the minimum after every value
+     * @returns T	the minimum after the last value
+     */
+    T update(const T* in, size_t count, T* out = nullptr)
+    {
+        for (size_t i = 0; i < count; i++) {
+            this->push(in[i]);
+            if (out) {
+                out[i] = this->min();
+            }
+        }
+        return this->min();
+    }
+
+    T getValue() const
+    {
+        return this->min();
+    }
+};
+
+/**
+ * Moving maximum over the last n values, see MovingMin
+ */
+template <class T, uint16_t N = 0>
+class MovingMax : public MovingExtrema<T, N, false, true> {
+    typedef MovingExtrema<T, N, false, true> Base;
+
+public:
+    template <uint16_t M = N, typename std::enable_if<M == 0, int>::type = 0>
+    MovingMax(const uint16_t n, T init = 0)
+        : Base(n, init)
+    {
+    }
+
+    template <uint16_t M = N, typename std::enable_if<M != 0, int>::type = 0>
+    MovingMax(T init = 0)
+        : Base(N, init)
+    {
+    }
+
+    T update(const T val)
+    {
+        this->push(val);
+        return this->max();
+    }
+
+    /**
+     * @name update
+     * @param in	block of count values
+     * @param out	optional, receives the maximum after every value
+     * @returns T	the maximum after the last value
+     */
+    T update(const T* in, size_t count, T* out = nullptr)
+    {
+        for (size_t i = 0; i < count; i++) {
+            this->push(in[i]);
+            if (out) {
+                out[i] = this->max();
+            }
+        }
+        return this->max();
+    }
+
+    T getValue() const
+    {
+        return this->max();
+    }
+};
+
+/**
+ * Moving minimum and maximum over the last n values sharing one ring, see MovingMin
+ * update() returns the range max - min, e.g. for peak-to-peak detection.
+ */
+template <class T, uint16_t N = 0>
+class MovingRange : public MovingExtrema<T, N, true, true> {
+    typedef MovingExtrema<T, N, true, true> Base;
+
+public:
+    template <uint16_t M = N, typename std::enable_if<M == 0, int>::type = 0>
+    MovingRange(const uint16_t n, T init = 0)
+        : Base(n, init)
+    {
+    }
+
+    template <uint16_t M = N, typename std::enable_if<M != 0, int>::type = 0>
+    MovingRange(T init = 0)
+        : Base(N, init)
+    {
+    }
+
+    T update(const T val)
+    {
+        this->push(val);
+        return this->getRange();
+    }
+
+    /**
+     * @name update
+     * @param in		block of count values
+     * @param outMin	optional, receives the minimum after every value
+     * @param outMax	optional, receives the maximum after every value
+     * @returns T		the range after the last value
+     */
+    T update(const T* in, size_t count, T* outMin = nullptr, T* outMax = nullptr)
+    {
+        for (size_t i = 0; i < count; i++) {
+            this->push(in[i]);
+            if (outMin) {
+                outMin[i] = this->min();
+            }
+            if (outMax) {
+                outMax[i] = this->max();
+            }
+        }
+        return this->getRange();
+    }
+
+    T getMin() const
+    {
+        return this->min();
+    }
+
+    T getMax() const
+    {
+        return this->max();
+    }
+
+    T getRange() const
+    {
+        return this->max() - this->min();
+    }
+};
+
+#endif
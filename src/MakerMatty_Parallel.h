@@ -0,0 +1,282 @@
+/**
+ * Author	: @makermatty (maker.matejsuchanek.cz)
+ * Date		: 15-10-2026
+ *
+ * Multi-threaded offline filtering (host only, needs std::thread, link Threads::Threads)
+ * For recordings far larger than any window: the input is split into one chunk per thread,
+ * every chunk is filtered on its own thread and the results are joined so they match the
+ * serial update of the filter. Not part of MakerMatty_Curves.h, include it explicitly.
+ */
+
+#ifndef _MM_PARALLEL_H
+#define _MM_PARALLEL_H
+
+#include "MakerMatty_EMA.h"
+#include "MakerMatty_MA.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Small fixed thread pool
+ * run() hands out task indices to the workers and the calling thread and returns when all
+ * of them are done. One run() at a time.
+ */
+class MMThreadPool {
+
+public:
+    explicit MMThreadPool(unsigned threads = 0);
+    ~MMThreadPool();
+
+    MMThreadPool(const MMThreadPool&) = delete;
+    MMThreadPool& operator=(const MMThreadPool&) = delete;
+
+    void run(const size_t tasks, const std::function<void(size_t)>& task);
+
+    unsigned getThreads() const;
+
+private:
+    void work();
+    void drain();
+
+    std::vector<std::thread> m_workers;
+    std::mutex m_mutex;
+    std::condition_variable m_wake; // a run started or the pool stops
+    std::condition_variable m_idle; // a worker left the current run
+    const std::function<void(size_t)>* m_task; // task of the current run
+    size_t m_tasks; // number of tasks of the current run
+    std::atomic<size_t> m_next; // next task index to hand out
+    unsigned m_active; // workers inside the current run
+    uint32_t m_generation; // incremented by every run
+    bool m_stop;
+};
+
+/**
+ * @name MMThreadPool Constructor
+ * @param threads	threads including the caller of run(), 0 for one per hardware thread
+ */
+inline MMThreadPool::MMThreadPool(unsigned threads)
+    : m_task(nullptr)
+    , m_tasks(0)
+    , m_next(0)
+    , m_active(0)
+    , m_generation(0)
+    , m_stop(false)
+{
+    if (threads == 0) {
+        threads = std::thread::hardware_concurrency();
+    }
+    for (unsigned i = 1; i < threads; i++) {
+        m_workers.emplace_back(&MMThreadPool::work, this);
+    }
+}
+
+inline MMThreadPool::~MMThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (std::thread& worker : m_workers) {
+        worker.join();
+    }
+}
+
+inline unsigned MMThreadPool::getThreads() const
+{
+    return (unsigned)m_workers.size() + 1;
+}
+
+/**
+ * @name run
+ * @param tasks		number of tasks
+ * @param task		called once with every index in [0, tasks), from any thread
+ */
+inline void MMThreadPool::run(const size_t tasks, const std::function<void(size_t)>& task)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_task = &task;
+        m_tasks = tasks;
+        m_next = 0;
+        m_active = (unsigned)m_workers.size();
+        ++m_generation;
+    }
+    m_wake.notify_all();
+
+    this->drain();
+
+    // every worker has to leave the run before task goes out of scope
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idle.wait(lock, [this] { return m_active == 0; });
+    m_task = nullptr;
+}
+
+inline void MMThreadPool::drain()
+{
+    for (size_t i = m_next++; i < m_tasks; i = m_next++) {
+        (*m_task)(i);
+    }
+}
+
+inline void MMThreadPool::work()
+{
+    uint32_t generation = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&] { return m_stop || m_generation != generation; });
+            if (m_stop) {
+                return;
+            }
+            generation = m_generation;
+        }
+
+        this->drain();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            --m_active;
+        }
+        m_idle.notify_one();
+    }
+}
+
+// chunks shorter than this are not worth a thread
+#ifndef MM_PARALLEL_MIN_CHUNK
+#define MM_PARALLEL_MIN_CHUNK 16384
+#endif
+
+/**
+ * @name EMAParallelUpdate
+ * @param ema		filter to continue, ends in the same state as after ema.update(in, count, out)
+ * @param in		block of count samples
+ * @param count		number of samples
+ * @param out		optional, receives the filtered value after every sample
+ * @param pool		threads to use
+ * @returns T		the value after the last sample
+ * The EMA step v' = alpha * x + beta * v is an affine map of v, so a chunk of L samples
+ * started from 0 ends at z and started from s ends at z + beta^L * s:
+ *   1. every chunk is filtered from 0 in parallel, giving z (no output written)
+ *   2. the true start of every chunk follows serially from the previous one
+ *   3. every chunk is filtered again from its true start in parallel, writing out
+ * The first chunk is bit-for-bit the serial result. Later chunks start within a few
+ * rounding errors of the serial value (the error of z + beta^L * s) and that difference
+ * decays by beta every sample. Without out only the last chunk is filtered again, for the
+ * state. Inputs below two chunks of MM_PARALLEL_MIN_CHUNK are filtered serially.
+ */
+template <class T, int N>
+T EMAParallelUpdate(EMABasic<T, N>& ema, const T* in, const size_t count, T* out, MMThreadPool& pool)
+{
+    typedef typename EMACoefficient<T>::type K;
+
+    size_t chunks = pool.getThreads();
+    if (count / MM_PARALLEL_MIN_CHUNK < chunks) {
+        chunks = count / MM_PARALLEL_MIN_CHUNK;
+    }
+    if (chunks < 2) {
+        return ema.update(in, count, out);
+    }
+
+    const size_t length = count / chunks; // the last chunk also takes the remainder
+    std::vector<T> starts(chunks + 1);
+    std::vector<T> zeros(chunks);
+
+    // 1. every chunk from 0, the last one is not needed
+    pool.run(chunks - 1, [&](size_t c) {
+        EMABasic<T, N> local(ema); // ema is only read
+        local.setValue(T());
+        zeros[c] = local.update(in + c * length, length);
+    });
+
+    // 2. true starts, beta^L is the same for all full chunks
+    const K decay = EMAPower(K(1) - ema.getAlpha(), (uint64_t)length);
+    starts[0] = ema.getValue();
+    for (size_t c = 0; c + 1 < chunks; c++) {
+        starts[c + 1] = zeros[c] + starts[c] * decay;
+    }
+
+    // 3. every chunk from its start, the last one continues ema itself
+    const EMABasic<T, N> first(ema);
+    pool.run(out ? chunks : 1, [&](size_t task) {
+        const size_t c = out ? task : chunks - 1;
+        const size_t begin = c * length;
+        const size_t end = c + 1 == chunks ? count : begin + length;
+
+        if (c + 1 == chunks) {
+            ema.setValue(starts[c]);
+            ema.update(in + begin, end - begin, out ? out + begin : nullptr);
+        } else if (c == 0) {
+            EMABasic<T, N> local(first);
+            local.update(in, end, out);
+        } else {
+            EMABasic<T, N> local(first);
+            local.setValue(starts[c]);
+            local.update(in + begin, end - begin, out + begin);
+        }
+    });
+
+    return ema.getValue();
+}
+
+/**
+ * @name MAParallel
+ * @param in		block of count values
+ * @param count		number of values
+ * @param n			number of values averaged
+ * @param out		receives the moving average after every value
+ * @param pool		threads to use
+ * Same outputs as a new MA<T, A>(n) updated with every value, including the averages over
+ * fewer values while the window fills. Every chunk seeds its sum from the n values before
+ * it and then slides on its own. Integer averages are bit-for-bit those of MA, floating
+ * point sums round in another order than the running sum of MA and may differ in the last
+ * bits. Inputs below two chunks of MM_PARALLEL_MIN_CHUNK (or of n) are averaged serially.
+ */
+template <class T, class A = typename MAAccumulator<T>::type>
+void MAParallel(const T* in, const size_t count, uint16_t n, T* out, MMThreadPool& pool)
+{
+    if (n == 0) {
+        log_e("n must not be 0");
+        n = 1;
+    }
+
+    const size_t minimum = n > MM_PARALLEL_MIN_CHUNK ? n : MM_PARALLEL_MIN_CHUNK;
+    size_t chunks = pool.getThreads();
+    if (count / minimum < chunks) {
+        chunks = count / minimum;
+    }
+    if (chunks < 1) {
+        chunks = 1;
+    }
+
+    const size_t length = count / chunks; // the last chunk also takes the remainder
+    const MADivider<A> divider(n);
+
+    pool.run(chunks, [&](size_t c) {
+        const size_t begin = c * length;
+        const size_t end = c + 1 == chunks ? count : begin + length;
+
+        // the window before the first value of the chunk
+        A sum = 0;
+        for (size_t i = begin > n ? begin - n : 0; i < begin; i++) {
+            sum += (A)in[i];
+        }
+
+        size_t i = begin;
+        for (; i < end && i < n; i++) {
+            sum = sum + (A)in[i];
+            out[i] = (T)(sum / (A)(i + 1));
+        }
+        for (; i < end; i++) {
+            sum = sum - (A)in[i - n] + (A)in[i];
+            out[i] = (T)divider.divide(sum);
+        }
+    });
+}
+
+#endif
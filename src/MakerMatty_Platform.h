@@ -0,0 +1,39 @@
+/**
+ * Author	: @makermatty (maker.matejsuchanek.cz)
+ * Date		: 15-10-2026
+ *
+ * Platform shim
+ * Pulls in what the filters need from the Arduino core on the device and
+ * from the C++ standard library everywhere else, so the same headers build
+ * natively (Linux, macOS) for replaying and batch processing recorded data.
+ */
+
+#ifndef _MM_PLATFORM_H
+#define _MM_PLATFORM_H
+
+#if defined(ARDUINO)
+#include <Arduino.h>
+#else
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#endif
+
+#include <utility>
+
+// std::exchange is C++14, older toolchains get it from stl_exchange.h
+#if __cplusplus < 201402L
+#include "stl_exchange.h"
+#endif
+
+// ESP32 core provides log_e, mirror it on host builds
+#ifndef log_e
+#if defined(ARDUINO)
+#define log_e(format, ...)
+#else
+#define log_e(format, ...) fprintf(stderr, "[E][%s:%u] %s(): " format "\n", __FILE__, __LINE__, __func__, ##__VA_ARGS__)
+#endif
+#endif
+
+#endif
@@ -0,0 +1,244 @@
+/**
+ * Author	: @makermatty (maker.matejsuchanek.cz)
+ * Date		: 15-10-2026
+ *
+ * Lock-free single producer / single consumer sample queue
+ * Hands samples from an interrupt (ADC, timer) to the task running the filters without a
+ * critical section. push() never blocks or loops: when the queue is full it drops either
+ * the new sample (MM_QUEUE_DROP_NEWEST) or the oldest one (MM_QUEUE_DROP_OLDEST) and counts
+ * it. The consumer drains in blocks with pop(out, max) and passes them to the block
+ * update APIs of the filters:
+ *
+ * 	MMSPSCQueue<int16_t, 256> queue;
+ * 	// ISR:  queue.push(adc);
+ * 	// task: n = queue.pop(block, 64); ma.update(block, n);
+ *
+ * The read and write positions are free running 32 bit counters (lock-free on the ESP32
+ * and on hosts), N is a power of two so a slot is the position masked.
+ * Dropping the oldest sample moves the read position from the producer side, so there
+ * both sides advance it with a compare-exchange: a pop() that lost the race to the
+ * producer discards what it copied and copies again from the new position.
+ */
+
+#ifndef _MM_QUEUE_H
+#define _MM_QUEUE_H
+
+#include "MakerMatty_Platform.h"
+
+#include <atomic>
+#include <type_traits>
+
+/**
+ * Whether std::atomic of an object of S bytes is always lock-free (the ATOMIC_*_LOCK_FREE
+ * macros, C++11 has no is_always_lock_free). A locked atomic would take a lock in the ISR.
+ */
+template <size_t S>
+struct MMAtomicLockFree {
+    static const bool value = false;
+};
+
+template <>
+struct MMAtomicLockFree<1> {
+    static const bool value = ATOMIC_CHAR_LOCK_FREE == 2;
+};
+
+template <>
+struct MMAtomicLockFree<2> {
+    static const bool value = ATOMIC_SHORT_LOCK_FREE == 2;
+};
+
+template <>
+struct MMAtomicLockFree<4> {
+    static const bool value = ATOMIC_INT_LOCK_FREE == 2;
+};
+
+template <>
+struct MMAtomicLockFree<8> {
+    static const bool value = ATOMIC_LLONG_LOCK_FREE == 2;
+};
+
+enum MMQueueOverflow {
+    MM_QUEUE_DROP_NEWEST, // a full queue rejects the new sample
+    MM_QUEUE_DROP_OLDEST, // a full queue discards its oldest sample
+};
+
+template <class T, uint16_t N, MMQueueOverflow P = MM_QUEUE_DROP_NEWEST>
+class MMSPSCQueue {
+    static_assert(N > 0 && (N & (N - 1)) == 0, "N must be a power of two");
+    static_assert(std::is_trivially_copyable<T>::value, "samples are copied as bytes");
+    static_assert(MMAtomicLockFree<sizeof(uint32_t)>::value, "positions need lock-free 32 bit atomics");
+    // e.g. 8 byte samples on the 32 bit ESP32 would go through libatomic's locks
+    static_assert(P != MM_QUEUE_DROP_OLDEST || MMAtomicLockFree<sizeof(T)>::value,
+        "MM_QUEUE_DROP_OLDEST needs lock-free atomics of T, use a 1, 2 or 4 byte sample");
+
+    // the producer may overwrite a slot the consumer is copying when dropping the oldest,
+    // relaxed atomic slots keep that defined (plain loads and stores where they are
+    // lock-free, which the assertion above guarantees)
+    typedef typename std::conditional<P == MM_QUEUE_DROP_OLDEST, std::atomic<T>, T>::type Slot;
+
+public:
+    MMSPSCQueue()
+        : m_read(0)
+        , m_write(0)
+        , m_pushed(0)
+        , m_dropped(0)
+    {
+    }
+
+    MMSPSCQueue(const MMSPSCQueue&) = delete;
+    MMSPSCQueue& operator=(const MMSPSCQueue&) = delete;
+
+    /**
+     * @name push
+     * Producer only.
+     * @param val		sample to add
+     * @returns bool	false when a sample was dropped, val itself or the oldest one
+     */
+    bool push(const T val)
+    {
+        const uint32_t w = m_write.load(std::memory_order_relaxed);
+        uint32_t r = m_read.load(std::memory_order_acquire);
+        bool kept = true;
+
+        m_pushed.store(m_pushed.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+        if (w - r == N) {
+            // a failed exchange means the consumer just made room
+            if (P == MM_QUEUE_DROP_NEWEST
+                || m_read.compare_exchange_strong(r, r + 1, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                m_dropped.store(m_dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                kept = false;
+            }
+            if (P == MM_QUEUE_DROP_NEWEST) {
+                return false;
+            }
+        }
+
+        store(m_data[w & (N - 1)], val);
+        m_write.store(w + 1, std::memory_order_release);
+        return kept;
+    }
+
+    /**
+     * @name push
+     * Producer only, e.g. with one DMA buffer.
+     * @param in		block of count samples
+     * @returns size_t	number of samples dropped
+     */
+    size_t push(const T* in, size_t count)
+    {
+        size_t dropped = 0;
+        for (size_t i = 0; i < count; i++) {
+            dropped += this->push(in[i]) ? 0 : 1;
+        }
+        return dropped;
+    }
+
+    /**
+     * @name pop
+     * Consumer only.
+     * @param val		receives the oldest sample
+     * @returns bool	false when the queue is empty
+     */
+    bool pop(T& val)
+    {
+        return this->pop(&val, 1) == 1;
+    }
+
+    /**
+     * @name pop
+     * Consumer only.
+     * @param out		receives up to max of the oldest samples, in order
+     * @returns size_t	number of samples written to out
+     */
+    size_t pop(T* out, size_t max)
+    {
+        uint32_t r = m_read.load(std::memory_order_acquire);
+        for (;;) {
+            const uint32_t w = m_write.load(std::memory_order_acquire);
+            if (w - r > N) {
+                // r went stale while the producer kept dropping the oldest
+                r = m_read.load(std::memory_order_acquire);
+                continue;
+            }
+            const size_t count = (size_t)(w - r) < max ? (size_t)(w - r) : max;
+            if (count == 0) {
+                return 0;
+            }
+
+            // oldest slots up to the end of the array, then from its start
+            const uint32_t index = r & (N - 1);
+            const size_t first = count < (size_t)(N - index) ? count : (size_t)(N - index);
+            copy(out, m_data + index, first);
+            copy(out + first, m_data, count - first);
+
+            if (P == MM_QUEUE_DROP_NEWEST) {
+                m_read.store(r + (uint32_t)count, std::memory_order_release);
+                return count;
+            }
+            // the producer dropped the oldest meanwhile, the copy may be torn, r is reloaded
+            if (m_read.compare_exchange_strong(r, r + (uint32_t)count, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                return count;
+            }
+        }
+    }
+
+    /**
+     * @name getCount
+     * @returns uint16_t	samples waiting, exact only from the consumer side
+     */
+    uint16_t getCount() const
+    {
+        const uint32_t r = m_read.load(std::memory_order_acquire);
+        const uint32_t w = m_write.load(std::memory_order_acquire);
+        return (uint16_t)(w - r > N ? N : w - r);
+    }
+
+    uint16_t getSize() const
+    {
+        return N;
+    }
+
+    // samples given to push(), kept or not
+    uint32_t getPushed() const
+    {
+        return m_pushed.load(std::memory_order_relaxed);
+    }
+
+    // samples lost to a full queue
+    uint32_t getDropped() const
+    {
+        return m_dropped.load(std::memory_order_relaxed);
+    }
+
+private:
+    static void store(T& slot, const T val)
+    {
+        slot = val;
+    }
+
+    static void store(std::atomic<T>& slot, const T val)
+    {
+        slot.store(val, std::memory_order_relaxed);
+    }
+
+    static void copy(T* out, const T* slots, const size_t count)
+    {
+        memcpy(out, slots, count * sizeof(T));
+    }
+
+    static void copy(T* out, const std::atomic<T>* slots, const size_t count)
+    {
+        for (size_t i = 0; i < count; i++) {
+            out[i] = slots[i].load(std::memory_order_relaxed);
+        }
+    }
+
+    Slot m_data[N];
+    std::atomic<uint32_t> m_read; // position of the oldest sample
+    std::atomic<uint32_t> m_write; // position the next sample goes to
+    std::atomic<uint32_t> m_pushed; // written by the producer only
+    std::atomic<uint32_t> m_dropped; // written by the producer only
+};
+
+#endif
@@ -0,0 +1,153 @@
+/**
+ * Author	: @makermatty (maker.matejsuchanek.cz)
+ * Date		: 15-10-2026
+ *
+ * Ring buffer storage of the window filters
+ * The last n values plus K arrays of n uint16_t (ring positions, heap slots, ...) that
+ * the order statistics filters (MovingMin, MovingMedian, ...) keep next to them.
+ * N > 0 keeps everything inline, N == 0 takes n at runtime and allocates it once.
+ */
+
+#ifndef _MM_RING_H
+#define _MM_RING_H
+
+#include "MakerMatty_Platform.h"
+
+template <class T, uint16_t N, uint8_t K>
+class MMRingStorage {
+    static_assert(K > 0, "use a plain array");
+
+public:
+    MMRingStorage(const uint16_t)
+    {
+    }
+
+    uint16_t size() const
+    {
+        return N;
+    }
+
+    T* data()
+    {
+        return m_data;
+    }
+
+    const T* data() const
+    {
+        return m_data;
+    }
+
+    uint16_t* index(const uint8_t k)
+    {
+        return m_index[k];
+    }
+
+    const uint16_t* index(const uint8_t k) const
+    {
+        return m_index[k];
+    }
+
+private:
+    T m_data[N];
+    uint16_t m_index[K][N];
+};
+
+template <class T, uint8_t K>
+class MMRingStorage<T, 0, K> {
+    static_assert(K > 0, "use a plain array");
+
+public:
+    MMRingStorage(const uint16_t n)
+        : m_n(n)
+        , m_memory(new uint64_t[words()])
+    {
+    }
+
+    MMRingStorage(const MMRingStorage& other) // copy contructor
+        : m_n(other.m_n)
+        , m_memory(other.m_memory ? new uint64_t[other.words()] : nullptr)
+    {
+        if (m_memory) {
+            memcpy(m_memory, other.m_memory, words() * sizeof(uint64_t));
+        }
+    }
+
+    MMRingStorage(MMRingStorage&& other) noexcept // move contructor
+        : m_n(std::exchange(other.m_n, 0))
+        , m_memory(std::exchange(other.m_memory, nullptr))
+    {
+    }
+
+    ~MMRingStorage()
+    {
+        delete[] m_memory;
+    }
+
+    MMRingStorage& operator=(const MMRingStorage& other)
+    {
+        if (this != &other) {
+            MMRingStorage(other).swap(*this); // Copy-constructor and non-throwing swap
+        }
+        return *this;
+    }
+
+    MMRingStorage& operator=(MMRingStorage&& other) noexcept
+    {
+        // Guard self assignment
+        if (this == &other)
+            return *this;
+
+        delete[] m_memory;
+        m_n = std::exchange(other.m_n, 0);
+        m_memory = std::exchange(other.m_memory, nullptr);
+        return *this;
+    }
+
+    void swap(MMRingStorage& other) noexcept
+    {
+        std::swap(this->m_n, other.m_n);
+        std::swap(this->m_memory, other.m_memory);
+    }
+
+    uint16_t size() const
+    {
+        return m_n;
+    }
+
+    T* data()
+    {
+        return (T*)m_memory;
+    }
+
+    const T* data() const
+    {
+        return (const T*)m_memory;
+    }
+
+    uint16_t* index(const uint8_t k)
+    {
+        return (uint16_t*)((uint8_t*)m_memory + dataBytes()) + (size_t)k * m_n;
+    }
+
+    const uint16_t* index(const uint8_t k) const
+    {
+        return (const uint16_t*)((const uint8_t*)m_memory + dataBytes()) + (size_t)k * m_n;
+    }
+
+private:
+    // values first (aligned by the allocation), the index arrays behind them
+    size_t dataBytes() const
+    {
+        return ((size_t)m_n * sizeof(T) + 1) & ~(size_t)1;
+    }
+
+    size_t words() const
+    {
+        return (dataBytes() + (size_t)K * m_n * sizeof(uint16_t) + 7) / 8;
+    }
+
+    uint16_t m_n; // number of elements in our array
+    uint64_t* m_memory; // values, index arrays
+};
+
+#endif
@@ -0,0 +1,88 @@
+/**
+ * Author	: @makermatty (maker.matejsuchanek.cz)
+ * Date		: 15-10-2026
+ *
+ * MADivider against the / operator for every divisor 1..65535
+ * Numerators around the multiples of the divisor, where a wrong magic number rounds
+ * the wrong way, near the ends of the accumulator range and pseudo-random ones, both
+ * signs. Covers the 64 bit magic (int64_t) and the 32 bit one (int32_t, uint32_t).
+ */
+
+#include "MakerMatty_MA.h"
+
+#include <cstdio>
+#include <limits>
+
+namespace {
+
+template <class A>
+unsigned long testDivider(const char* name)
+{
+    const uint64_t big = (uint64_t)std::numeric_limits<A>::max();
+    const int digits = std::numeric_limits<A>::digits;
+    uint64_t seed = 0x9e3779b97f4a7c15ull;
+    unsigned long failures = 0;
+
+    for (uint32_t d = 1; d <= 65535; d++) {
+        const MADivider<A> divider((uint16_t)d);
+        const uint64_t top = big / d * d; // largest multiple of d
+        uint64_t magnitudes[] = {
+            0, 1, d - 1, d, d + 1, 2 * (uint64_t)d - 1, 2 * (uint64_t)d,
+            65535 * (uint64_t)d - 1, 65535 * (uint64_t)d, (uint64_t)1 << 31, ((uint64_t)1 << 47) + 12345,
+            top - 1, top, big - 1, big,
+            0, 0, 0, 0, // random
+        };
+        const size_t count = sizeof(magnitudes) / sizeof(magnitudes[0]);
+        for (size_t i = count - 4; i < count; i++) {
+            seed ^= seed << 13;
+            seed ^= seed >> 7;
+            seed ^= seed << 17;
+            magnitudes[i] = seed >> (64 - digits + (i + 4 - count) * digits / 8); // full width and shorter
+        }
+
+        for (const uint64_t m : magnitudes) {
+            if (m > big) {
+                continue;
+            }
+            const A n = (A)m;
+            for (int negative = 0; negative <= (std::numeric_limits<A>::is_signed ? 1 : 0); negative++) {
+                const A x = negative ? (A)-n : n;
+                const A expected = x / (A)d;
+                const A got = divider.divide(x);
+                if (got != expected && failures++ < 10) {
+                    printf("%s %lld / %u: %lld, expected %lld\n", name, (long long)x, d, (long long)got, (long long)expected);
+                }
+            }
+        }
+
+        if (std::numeric_limits<A>::is_signed) {
+            const A min = std::numeric_limits<A>::min();
+            if (divider.divide(min) != min / (A)d && failures++ < 10) {
+                printf("%s min / %u\n", name, d);
+            }
+        }
+    }
+
+    printf("%s: %lu failures\n", name, failures);
+    return failures;
+}
+
+} // namespace
+
+int main()
+{
+    unsigned long failures = 0;
+    failures += testDivider<int64_t>("int64_t");
+    failures += testDivider<int32_t>("int32_t");
+    failures += testDivider<uint32_t>("uint32_t");
+
+    // compile-time divisor
+    constexpr MADivider<int64_t> constant(100);
+    constexpr MADivider<int32_t> constant32(100);
+    if (constant.divide(-12345) != -123 || constant32.divide(-12345) != -123) {
+        printf("constexpr divider\n");
+        failures++;
+    }
+
+    return failures ? 1 : 0;
+}
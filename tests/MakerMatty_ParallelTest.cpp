@@ -0,0 +1,120 @@
+/**
+ * Author	: @makermatty (maker.matejsuchanek.cz)
+ * Date		: 15-10-2026
+ *
+ * Offline parallel filters against their serial update
+ * EMAParallelUpdate must give the outputs and the final state of EMA::update up to the
+ * rounding of the chunk starts, MAParallel the outputs of MA<T>::update including the
+ * averages while the window fills, exact for integers. Uses 4 threads whatever the host
+ * has, so the chunk joins are always exercised.
+ */
+
+#include "MakerMatty_Parallel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+const size_t kSamples = 1 << 22;
+
+template <class T>
+std::vector<T> makeSignal(size_t count)
+{
+    std::vector<T> signal(count);
+    uint32_t seed = 0x12345678;
+    for (size_t i = 0; i < count; i++) {
+        seed = seed * 1664525 + 1013904223;
+        signal[i] = (T)((int32_t)(seed >> 16) - 32768);
+    }
+    return signal;
+}
+
+template <class T>
+int testEMA(MMThreadPool& pool, const char* type, int n, double tolerance)
+{
+    const std::vector<T> in = makeSignal<T>(kSamples);
+    std::vector<T> expected(kSamples);
+    std::vector<T> got(kSamples);
+
+    EMABasic<T> serial(n, 100);
+    EMABasic<T> parallel(n, 100);
+    serial.update(in.data(), kSamples, expected.data());
+    EMAParallelUpdate(parallel, in.data(), kSamples, got.data(), pool);
+
+    // the first chunk is exact, the later ones start a few roundings off
+    double worst = 0;
+    for (size_t i = 0; i < kSamples; i++) {
+        worst = std::max(worst, (double)std::fabs(expected[i] - got[i]));
+    }
+    const size_t firstChunk = kSamples / pool.getThreads();
+    bool exact = true;
+    for (size_t i = 0; i < firstChunk; i++) {
+        exact = exact && expected[i] == got[i];
+    }
+
+    // without out only the state is kept
+    EMABasic<T> state(n, 100);
+    EMAParallelUpdate(state, in.data(), kSamples, (T*)nullptr, pool);
+
+    const bool ok = exact && worst <= tolerance
+        && std::fabs(parallel.getValue() - serial.getValue()) <= tolerance
+        && std::fabs(state.getValue() - serial.getValue()) <= tolerance
+        && std::fabs(parallel.getSlope() - serial.getSlope()) <= tolerance;
+    printf("EMAParallelUpdate<%s> n=%d: worst %g, first chunk %s, %s\n", type, n, worst, exact ? "exact" : "differs", ok ? "ok" : "FAILED");
+    return ok ? 0 : 1;
+}
+
+template <class T>
+int testMA(MMThreadPool& pool, const char* type, uint16_t n, size_t count)
+{
+    const std::vector<T> in = makeSignal<T>(count);
+    std::vector<T> expected(count);
+    std::vector<T> got(count);
+
+    MA<T> serial(n);
+    serial.update(in.data(), count, expected.data());
+    MAParallel(in.data(), count, n, got.data(), pool);
+
+    size_t differs = 0;
+    double worst = 0;
+    for (size_t i = 0; i < count; i++) {
+        differs += expected[i] != got[i];
+        worst = std::max(worst, std::fabs((double)expected[i] - (double)got[i]));
+    }
+
+    const bool ok = std::is_integral<T>::value ? differs == 0 : worst <= 1e-3;
+    printf("MAParallel<%s> n=%u count=%zu: %zu differ, worst %g, %s\n", type, n, count, differs, worst, ok ? "ok" : "FAILED");
+    return ok ? 0 : 1;
+}
+
+} // namespace
+
+int main()
+{
+    MMThreadPool pool(4);
+    int failures = 0;
+
+    // long periods keep the chunk starts from being remembered to the end of the chunk,
+    // samples are up to 32768, float tolerance allows for its own rounding at small alpha
+    for (int n : { 1, 16, 65535, 1 << 20 }) {
+        failures += testEMA<float>(pool, "float", n, 0.05);
+    }
+    for (int n : { 16, 1 << 20, 1 << 24 }) {
+        failures += testEMA<double>(pool, "double", n, 1e-6);
+    }
+
+    // windows spanning several chunks and inputs too short to split
+    for (uint16_t n : { 1, 3, 100, 20000, 65535 }) {
+        failures += testMA<int16_t>(pool, "int16_t", n, 200000);
+        failures += testMA<int32_t>(pool, "int32_t", n, 300001);
+        failures += testMA<float>(pool, "float", n, 200000);
+        failures += testMA<int16_t>(pool, "int16_t", n, 1000);
+    }
+
+    printf("%d failures\n", failures);
+    return failures ? 1 : 0;
+}
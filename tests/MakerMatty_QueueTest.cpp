@@ -0,0 +1,131 @@
+/**
+ * Author	: @makermatty (maker.matejsuchanek.cz)
+ * Date		: 15-10-2026
+ *
+ * MMSPSCQueue with a producer and a consumer thread
+ * The producer pushes a counter, the consumer pops it in blocks of varying size:
+ *   lossy runs: what arrives is strictly increasing and kept + dropped == pushed, dropping
+ *     the oldest always delivers the last sample
+ *   lossless run: a producer retrying rejected samples delivers every sample in order
+ * Run it under -fsanitize=thread to check the memory ordering as well.
+ */
+
+#include "MakerMatty_Queue.h"
+
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+namespace {
+
+int testOverflow()
+{
+    MMSPSCQueue<int, 4> newest;
+    MMSPSCQueue<int, 4, MM_QUEUE_DROP_OLDEST> oldest;
+    for (int i = 0; i < 6; i++) {
+        newest.push(i);
+        oldest.push(i);
+    }
+
+    int out[8];
+    int value;
+    const size_t n = newest.pop(out, 8);
+    bool ok = n == 4 && out[0] == 0 && out[3] == 3 && newest.getDropped() == 2 && newest.getPushed() == 6;
+    const size_t o = oldest.pop(out, 8);
+    ok = ok && o == 4 && out[0] == 2 && out[3] == 5 && oldest.getDropped() == 2 && oldest.getPushed() == 6;
+    ok = ok && !newest.pop(value) && !oldest.pop(value) && newest.getCount() == 0;
+
+    printf("overflow policies: %s\n", ok ? "ok" : "FAILED");
+    return ok ? 0 : 1;
+}
+
+template <MMQueueOverflow P>
+int testLossy(const char* name, uint32_t total)
+{
+    MMSPSCQueue<uint32_t, 64, P> queue;
+    std::vector<uint32_t> got;
+    got.reserve(total);
+
+    std::thread producer([&] {
+        for (uint32_t i = 0; i < total; i++) {
+            queue.push(i);
+            if ((i & 1023) == 0) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    uint32_t block[37];
+    for (;;) {
+        const bool finished = queue.getPushed() == total; // read before the pop that drains
+        const size_t n = queue.pop(block, 1 + got.size() % 37);
+        got.insert(got.end(), block, block + n);
+        if (!n && finished) {
+            break;
+        }
+        if (!n) {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+
+    size_t disorder = 0;
+    for (size_t i = 1; i < got.size(); i++) {
+        disorder += got[i] <= got[i - 1];
+    }
+    bool ok = disorder == 0 && got.size() + queue.getDropped() == total && queue.getPushed() == total;
+    if (P == MM_QUEUE_DROP_OLDEST) {
+        ok = ok && !got.empty() && got.back() == total - 1;
+    }
+
+    printf("%s: %zu kept, %u dropped, %zu out of order, %s\n", name, got.size(), queue.getDropped(), disorder, ok ? "ok" : "FAILED");
+    return ok ? 0 : 1;
+}
+
+int testLossless(uint32_t total)
+{
+    MMSPSCQueue<uint32_t, 16> queue;
+
+    std::thread producer([&] {
+        for (uint32_t i = 0; i < total;) {
+            if (queue.push(i)) {
+                i++;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    uint32_t block[7];
+    uint32_t next = 0;
+    size_t wrong = 0;
+    while (next < total) {
+        const size_t n = queue.pop(block, 7);
+        for (size_t i = 0; i < n; i++) {
+            wrong += block[i] != next++;
+        }
+        if (!n) {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+
+    const bool ok = wrong == 0 && queue.getPushed() == total + queue.getDropped();
+    printf("lossless: %zu wrong, %s\n", wrong, ok ? "ok" : "FAILED");
+    return ok ? 0 : 1;
+}
+
+} // namespace
+
+int main()
+{
+    int failures = testOverflow();
+    for (int run = 0; run < 4; run++) {
+        failures += testLossy<MM_QUEUE_DROP_NEWEST>("drop newest", 1000000);
+        failures += testLossy<MM_QUEUE_DROP_OLDEST>("drop oldest", 1000000);
+    }
+    failures += testLossless(200000);
+
+    printf("%d failures\n", failures);
+    return failures ? 1 : 0;
+}
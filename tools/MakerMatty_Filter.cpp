@@ -0,0 +1,591 @@
+/**
+ * Author	: @makermatty (maker.matejsuchanek.cz)
+ * Date		: 15-10-2026
+ *
+ * Filters a recording of packed samples through a chain of EMA / MA filters
+ * The input is memory mapped and walked in blocks of frames: every channel of a block is
+ * converted to float, run through its own copy of the chain with the block update APIs
+ * and converted straight into the output, a mapped file or a buffer flushed to stdout.
+ * When the input or the output is i32, u32 or f64, which float cannot hold exactly, the
+ * chain runs in double instead.
+ * Memory stays at a few blocks whatever the size of the recording. Interleaved recordings
+ * are walked block by block, planar ones channel by channel, so both files are read and
+ * written front to back. Integer outputs are rounded and saturated.
+ *
+ * usage: MakerMatty_Filter [options] <input> <output | ->
+ *   -t <type>		sample type i8 u8 i16 u16 i32 u32 f32 f64 (default i16)
+ *   -o <type>		output sample type (default the input type)
+ *   -c <channels>	channels per frame (default 1)
+ *   -p				planar, every channel stored whole after the other (default interleaved)
+ *   -f <chain>		filters applied in order, e.g. ema:16,ma:8 (default ema:16)
+ *   -b <frames>	frames per block (default 4096)
+ * EMA filters start from the first sample of their channel, MA filters average the
+ * samples seen so far until their window fills.
+ */
+
+#include "MakerMatty_EMA.h"
+#include "MakerMatty_MA.h"
+
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+enum SampleType { I8, U8, I16, U16, I32, U32, F32, F64 };
+
+const char* const kTypeNames[] = { "i8", "u8", "i16", "u16", "i32", "u32", "f32", "f64" };
+const size_t kTypeSizes[] = { 1, 1, 2, 2, 4, 4, 4, 8 };
+
+bool parseType(const char* name, SampleType& type)
+{
+    for (int i = 0; i <= F64; i++) {
+        if (strcmp(name, kTypeNames[i]) == 0) {
+            type = (SampleType)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool parseCount(const char* text, unsigned long max, unsigned long& value)
+{
+    char* end;
+    errno = 0;
+    value = strtoul(text, &end, 10);
+    return errno == 0 && end != text && *end == '\0' && value > 0 && value <= max;
+}
+
+// every value of the type fits the 24 bit mantissa of float
+bool fitsFloat(SampleType type)
+{
+    return type != I32 && type != U32 && type != F64;
+}
+
+// stride in bytes between two samples of the same channel, K is the type the chain runs in
+template <class T, class K>
+void load(const uint8_t* src, size_t stride, K* dst, size_t count)
+{
+    for (size_t i = 0; i < count; i++, src += stride) {
+        T value;
+        memcpy(&value, src, sizeof(T));
+        dst[i] = (K)value;
+    }
+}
+
+template <class T, class K>
+void store(const K* src, uint8_t* dst, size_t stride, size_t count)
+{
+    for (size_t i = 0; i < count; i++, dst += stride) {
+        T value;
+        if (std::numeric_limits<T>::is_integer) {
+            const double rounded = std::nearbyint((double)src[i]);
+            value = rounded <= (double)std::numeric_limits<T>::min() ? std::numeric_limits<T>::min()
+                : rounded >= (double)std::numeric_limits<T>::max()   ? std::numeric_limits<T>::max()
+                : rounded == rounded                                  ? (T)rounded
+                                                                      : T(0); // NaN
+        } else {
+            value = (T)src[i];
+        }
+        memcpy(dst, &value, sizeof(T));
+    }
+}
+
+template <class K>
+void load(SampleType type, const uint8_t* src, size_t stride, K* dst, size_t count)
+{
+    switch (type) {
+    case I8: return load<int8_t>(src, stride, dst, count);
+    case U8: return load<uint8_t>(src, stride, dst, count);
+    case I16: return load<int16_t>(src, stride, dst, count);
+    case U16: return load<uint16_t>(src, stride, dst, count);
+    case I32: return load<int32_t>(src, stride, dst, count);
+    case U32: return load<uint32_t>(src, stride, dst, count);
+    case F32: return load<float>(src, stride, dst, count);
+    case F64: return load<double>(src, stride, dst, count);
+    }
+}
+
+template <class K>
+void store(SampleType type, const K* src, uint8_t* dst, size_t stride, size_t count)
+{
+    switch (type) {
+    case I8: return store<int8_t>(src, dst, stride, count);
+    case U8: return store<uint8_t>(src, dst, stride, count);
+    case I16: return store<int16_t>(src, dst, stride, count);
+    case U16: return store<uint16_t>(src, dst, stride, count);
+    case I32: return store<int32_t>(src, dst, stride, count);
+    case U32: return store<uint32_t>(src, dst, stride, count);
+    case F32: return store<float>(src, dst, stride, count);
+    case F64: return store<double>(src, dst, stride, count);
+    }
+}
+
+/**
+ * One filter of the chain, in and out never alias (MA copies in after writing out)
+ */
+template <class K>
+class Stage {
+
+public:
+    virtual ~Stage() { }
+    virtual void run(const K* in, size_t count, K* out) = 0;
+};
+
+template <class K>
+class EMAStage : public Stage<K> {
+
+public:
+    explicit EMAStage(int n)
+        : m_ema(n, K(0))
+        , m_started(false)
+    {
+    }
+
+    void run(const K* in, size_t count, K* out) override
+    {
+        if (!m_started && count) {
+            m_ema.setValue(in[0]);
+            m_started = true;
+        }
+        m_ema.update(in, count, out);
+    }
+
+private:
+    EMABasic<K> m_ema;
+    bool m_started; // seen the first sample
+};
+
+template <class K>
+class MAStage : public Stage<K> {
+
+public:
+    explicit MAStage(uint16_t n)
+        : m_ma(n)
+    {
+    }
+
+    void run(const K* in, size_t count, K* out) override
+    {
+        m_ma.update(in, count, out);
+    }
+
+private:
+    MA<K> m_ma;
+};
+
+/**
+ * @name parseChain
+ * @param text		filters separated by commas, name:n
+ * @param chain		receives a new instance of every filter
+ * @returns bool	false on a malformed filter
+ */
+template <class K>
+bool parseChain(const std::string& text, std::vector<std::unique_ptr<Stage<K>>>& chain)
+{
+    size_t begin = 0;
+    while (begin <= text.size()) {
+        size_t end = text.find(',', begin);
+        if (end == std::string::npos) {
+            end = text.size();
+        }
+        const std::string filter = text.substr(begin, end - begin);
+        const size_t colon = filter.find(':');
+        unsigned long n;
+        if (colon == std::string::npos || !parseCount(filter.c_str() + colon + 1, 65535, n)) {
+            fprintf(stderr, "bad filter '%s', expected ema:n or ma:n\n", filter.c_str());
+            return false;
+        }
+
+        const std::string name = filter.substr(0, colon);
+        if (name == "ema") {
+            chain.emplace_back(new EMAStage<K>((int)n));
+        } else if (name == "ma") {
+            chain.emplace_back(new MAStage<K>((uint16_t)n));
+        } else {
+            fprintf(stderr, "unknown filter '%s'\n", name.c_str());
+            return false;
+        }
+        begin = end + 1;
+    }
+    return true;
+}
+
+/**
+ * Read-only mapping of the whole input file
+ */
+class InputMap {
+
+public:
+    InputMap()
+        : m_data(nullptr)
+        , m_size(0)
+        , m_device(0)
+        , m_inode(0)
+    {
+    }
+
+    ~InputMap()
+    {
+        if (m_data) {
+            munmap(m_data, m_size);
+        }
+    }
+
+    bool open(const char* path)
+    {
+        const int fd = ::open(path, O_RDONLY);
+        if (fd < 0) {
+            fprintf(stderr, "%s: %s\n", path, strerror(errno));
+            return false;
+        }
+
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            fprintf(stderr, "%s: %s\n", path, strerror(errno));
+            close(fd);
+            return false;
+        }
+
+        m_device = st.st_dev;
+        m_inode = st.st_ino;
+        m_size = (size_t)st.st_size;
+        if (m_size) {
+            void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data == MAP_FAILED) {
+                fprintf(stderr, "%s: %s\n", path, strerror(errno));
+                close(fd);
+                return false;
+            }
+            m_data = data;
+            madvise(m_data, m_size, MADV_SEQUENTIAL);
+        }
+        close(fd); // the mapping keeps the file
+        return true;
+    }
+
+    const uint8_t* data() const
+    {
+        return (const uint8_t*)m_data;
+    }
+
+    size_t size() const
+    {
+        return m_size;
+    }
+
+    // path names the mapped file, opening it for output would truncate the input
+    bool isSameFile(const char* path) const
+    {
+        struct stat st;
+        return stat(path, &st) == 0 && st.st_dev == m_device && st.st_ino == m_inode;
+    }
+
+private:
+    void* m_data;
+    size_t m_size;
+    dev_t m_device;
+    ino_t m_inode;
+};
+
+/**
+ * Sequential output, next() hands out the space of the following bytes
+ * A regular file is sized up front and mapped, the samples are converted straight into
+ * it. Standard output goes through a buffer of one block.
+ */
+class OutputWriter {
+
+public:
+    OutputWriter()
+        : m_fd(-1)
+        , m_map(nullptr)
+        , m_size(0)
+        , m_used(0)
+    {
+    }
+
+    ~OutputWriter()
+    {
+        if (m_map) {
+            munmap(m_map, m_size);
+        }
+        if (m_fd > STDOUT_FILENO) {
+            close(m_fd);
+        }
+    }
+
+    bool open(const char* path, size_t size, size_t block)
+    {
+        if (strcmp(path, "-") == 0) {
+            m_fd = STDOUT_FILENO;
+            m_buffer.resize(block);
+            return true;
+        }
+
+        m_fd = ::open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (m_fd < 0 || ftruncate(m_fd, (off_t)size) != 0) {
+            fprintf(stderr, "%s: %s\n", path, strerror(errno));
+            return false;
+        }
+
+        m_size = size;
+        if (m_size) {
+            void* map = mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+            if (map == MAP_FAILED) {
+                fprintf(stderr, "%s: %s\n", path, strerror(errno));
+                return false;
+            }
+            m_map = (uint8_t*)map;
+        }
+        return true;
+    }
+
+    // bytes must not be larger than the block given to open()
+    uint8_t* next(size_t bytes)
+    {
+        if (m_map) {
+            uint8_t* space = m_map + m_used;
+            m_used += bytes;
+            return space;
+        }
+
+        if (m_used + bytes > m_buffer.size() && !this->flush()) {
+            return nullptr;
+        }
+        uint8_t* space = m_buffer.data() + m_used;
+        m_used += bytes;
+        return space;
+    }
+
+    bool finish()
+    {
+        if (m_map) {
+            if (msync(m_map, m_size, MS_SYNC) != 0) {
+                fprintf(stderr, "output: %s\n", strerror(errno));
+                return false;
+            }
+            return true;
+        }
+        return this->flush();
+    }
+
+private:
+    bool flush()
+    {
+        const uint8_t* data = m_buffer.data();
+        while (m_used) {
+            const ssize_t written = write(m_fd, data, m_used);
+            if (written < 0 && errno == EINTR) {
+                continue;
+            }
+            if (written <= 0) {
+                fprintf(stderr, "output: %s\n", strerror(errno));
+                return false;
+            }
+            data += written;
+            m_used -= (size_t)written;
+        }
+        return true;
+    }
+
+    int m_fd;
+    uint8_t* m_map; // mapped output file, nullptr when buffered
+    size_t m_size; // bytes of the mapped file
+    size_t m_used; // bytes handed out, of the map or of the buffer
+    std::vector<uint8_t> m_buffer;
+};
+
+struct Options {
+    SampleType type = I16;
+    SampleType outType = I16;
+    bool outTypeSet = false;
+    size_t channels = 1;
+    bool planar = false;
+    std::string chain = "ema:16";
+    size_t block = 4096;
+    const char* input = nullptr;
+    const char* output = nullptr;
+};
+
+void usage()
+{
+    fprintf(stderr,
+        "usage: MakerMatty_Filter [options] <input> <output | ->\n"
+        "  -t <type>      sample type i8 u8 i16 u16 i32 u32 f32 f64 (default i16)\n"
+        "  -o <type>      output sample type (default the input type)\n"
+        "  -c <channels>  channels per frame (default 1)\n"
+        "  -p             planar, every channel stored whole after the other\n"
+        "  -f <chain>     filters applied in order, e.g. ema:16,ma:8 (default ema:16)\n"
+        "  -b <frames>    frames per block (default 4096)\n");
+}
+
+bool parseOptions(int argc, char** argv, Options& options)
+{
+    unsigned long value;
+    int opt;
+    while ((opt = getopt(argc, argv, "t:o:c:pf:b:h")) != -1) {
+        switch (opt) {
+        case 't':
+            if (!parseType(optarg, options.type)) {
+                fprintf(stderr, "unknown sample type '%s'\n", optarg);
+                return false;
+            }
+            break;
+        case 'o':
+            if (!parseType(optarg, options.outType)) {
+                fprintf(stderr, "unknown sample type '%s'\n", optarg);
+                return false;
+            }
+            options.outTypeSet = true;
+            break;
+        case 'c':
+            if (!parseCount(optarg, 65535, value)) {
+                fprintf(stderr, "bad channel count '%s'\n", optarg);
+                return false;
+            }
+            options.channels = value;
+            break;
+        case 'p':
+            options.planar = true;
+            break;
+        case 'f':
+            options.chain = optarg;
+            break;
+        case 'b':
+            if (!parseCount(optarg, 1 << 24, value)) {
+                fprintf(stderr, "bad block size '%s'\n", optarg);
+                return false;
+            }
+            options.block = value;
+            break;
+        default:
+            return false;
+        }
+    }
+
+    if (argc - optind != 2) {
+        return false;
+    }
+    options.input = argv[optind];
+    options.output = argv[optind + 1];
+    if (!options.outTypeSet) {
+        options.outType = options.type;
+    }
+    return true;
+}
+
+/**
+ * @name filterRecording
+ * Runs every channel of the mapped input through its own chain in K and writes the result.
+ * @returns int	exit code
+ */
+template <class K>
+int filterRecording(const Options& options, const InputMap& input, size_t frames)
+{
+    // one chain per channel, every channel keeps its own state
+    std::vector<std::vector<std::unique_ptr<Stage<K>>>> chains(options.channels);
+    for (auto& chain : chains) {
+        if (!parseChain(options.chain, chain)) {
+            return 1;
+        }
+    }
+
+    const size_t inSize = kTypeSizes[options.type];
+    const size_t outSize = kTypeSizes[options.outType];
+    const size_t channels = options.channels;
+
+    // planar blocks hold one channel, interleaved blocks all of them
+    const size_t block = options.block;
+    OutputWriter output;
+    if (!output.open(options.output, frames * channels * outSize, block * outSize * (options.planar ? 1 : channels))) {
+        return 1;
+    }
+
+    std::vector<K> ping(block);
+    std::vector<K> pong(block);
+
+    // count samples of channel c, strides in bytes between two samples of the channel
+    auto filter = [&](size_t c, const uint8_t* src, size_t inStride, uint8_t* dst, size_t outStride, size_t count) {
+        K* a = ping.data();
+        K* b = pong.data();
+        load(options.type, src, inStride, a, count);
+        for (auto& stage : chains[c]) {
+            stage->run(a, count, b);
+            std::swap(a, b);
+        }
+        store(options.outType, a, dst, outStride, count);
+    };
+
+    if (options.planar) {
+        for (size_t c = 0; c < channels; c++) {
+            const uint8_t* src = input.data() + c * frames * inSize;
+            for (size_t f = 0; f < frames; f += block) {
+                const size_t count = frames - f < block ? frames - f : block;
+                uint8_t* dst = output.next(count * outSize);
+                if (!dst) {
+                    return 1;
+                }
+                filter(c, src + f * inSize, inSize, dst, outSize, count);
+            }
+        }
+    } else {
+        for (size_t f = 0; f < frames; f += block) {
+            const size_t count = frames - f < block ? frames - f : block;
+            const uint8_t* src = input.data() + f * channels * inSize;
+            uint8_t* dst = output.next(count * channels * outSize);
+            if (!dst) {
+                return 1;
+            }
+            for (size_t c = 0; c < channels; c++) {
+                filter(c, src + c * inSize, channels * inSize, dst + c * outSize, channels * outSize, count);
+            }
+        }
+    }
+
+    return output.finish() ? 0 : 1;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        usage();
+        return 1;
+    }
+
+    InputMap input;
+    if (!input.open(options.input)) {
+        return 1;
+    }
+    if (strcmp(options.output, "-") != 0 && input.isSameFile(options.output)) {
+        fprintf(stderr, "%s: output is the input file\n", options.output);
+        return 1;
+    }
+
+    const size_t inSize = kTypeSizes[options.type];
+    const size_t channels = options.channels;
+    const size_t frames = input.size() / (inSize * channels);
+    if (frames * inSize * channels != input.size()) {
+        fprintf(stderr, "%s: %zu bytes is not a whole number of %zu channel %s frames\n",
+            options.input, input.size(), channels, kTypeNames[options.type]);
+        return 1;
+    }
+
+    if (fitsFloat(options.type) && fitsFloat(options.outType)) {
+        return filterRecording<float>(options, input, frames);
+    }
+    return filterRecording<double>(options, input, frames);
+}